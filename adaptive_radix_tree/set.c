@@ -0,0 +1,1087 @@
+/*
+ * File:	set.c
+ *
+ * Description:	This file contains the implementation for a set abstract data type.
+ *              The algorithm used to implement the set is an adaptive radix tree. Each
+ *              inner node branches on one byte of the elements below it, so a search
+ *              reads each byte of the element sought once, in order, and compares it
+ *              with a whole string only at the leaf it ends at. The terminating NUL is
+ *              treated as part of each element, so no element is a prefix of another
+ *              and every element ends at a leaf of its own.
+ *
+ *              An inner node has one of four sizes, holding up to 4, 16, 48 or 256
+ *              children, and grows or shrinks to the next size as children are added
+ *              or removed. The smaller two keep the bytes of their children in a sorted
+ *              array, which a node of 16 searches with one SSE2 comparison where it is
+ *              available. A node of 48 maps each byte to a slot among its children, and
+ *              a node of 256 is indexed by the byte directly.
+ *
+ *              A chain of nodes with one child each is compressed into the prefix of
+ *              the node below it, so shared prefixes such as URL schemes and namespaces
+ *              cost one node rather than one per byte. Up to MAX_PREFIX bytes of the
+ *              prefix are kept in the node. A search only checks those and skips the
+ *              rest, since the comparison at the leaf catches any mismatch. An update
+ *              reads the rest from the leftmost leaf below the node.
+ *
+ *              The elements between two bounds, or with a given prefix, can be visited
+ *              in sorted order, since the children of each node are kept in order of
+ *              their bytes. Leaves and nodes come from pools owned by the set (see
+ *              ../common/pool.h), one for each size.
+ *
+ *              A set is an unordered collection of unique elements. Each element is a string.
+ *
+ */
+
+# include <stdio.h>
+# include <stdlib.h>
+# include <stdint.h>
+# include <string.h>
+# ifdef __SSE2__
+# include <emmintrin.h>
+# endif
+# include "set.h"
+# include "../common/pool.h"
+
+# define MAX_PREFIX 8 /* The most bytes of a compressed prefix kept in a node */
+
+/* The number of bytes of the prefix of `node` kept in it */
+# define STORED(node) ((node)->prefixLength < MAX_PREFIX ? (node)->prefixLength : MAX_PREFIX)
+
+/* A child pointer with its low bit set points to a leaf */
+# define IS_LEAF(p) ((uintptr_t) (p) & 1)
+# define TO_LEAF(p) ((LEAF *) ((uintptr_t) (p) - 1))
+# define FROM_LEAF(l) ((NODE *) ((uintptr_t) (l) + 1))
+
+/* The header of an inner node */
+typedef struct node
+{
+  unsigned short type; /* The most children the node can hold: 4, 16, 48 or 256 */
+
+  unsigned short count; /* The number of children */
+
+  int prefixLength; /* The number of bytes skipped before the node branches */
+
+  unsigned char prefix[MAX_PREFIX]; /* The first of the bytes skipped */
+} NODE;
+
+/* A node of up to 4 children, with their bytes in order */
+typedef struct node4
+{
+  NODE node;
+
+  unsigned char keys[4];
+
+  NODE *children[4];
+} NODE4;
+
+/* A node of up to 16 children, with their bytes in order */
+typedef struct node16
+{
+  NODE node;
+
+  unsigned char keys[16];
+
+  NODE *children[16];
+} NODE16;
+
+/* A node of up to 48 children, with the slot of each byte's child plus one, or 0 */
+typedef struct node48
+{
+  NODE node;
+
+  unsigned char index[256];
+
+  NODE *children[48];
+} NODE48;
+
+/* A node of up to 256 children, indexed by byte */
+typedef struct node256
+{
+  NODE node;
+
+  NODE *children[256];
+} NODE256;
+
+/* A leaf, holding one element */
+typedef struct leaf
+{
+  char *elt;
+} LEAF;
+
+/* Definition of the `set` data type */
+struct set
+{
+  int count; /* The number of elements currently in the set */
+
+  NODE *root; /* The root node or leaf, or NULL if the set is empty */
+
+  POOL leaves; /* The leaves */
+
+  POOL nodes4, nodes16, nodes48, nodes256; /* The inner nodes of each size */
+};
+
+/* The state of a scan, passed down the tree */
+typedef struct scan
+{
+  int (*visit) (char *elt, void *arg); /* The callback */
+
+  void *arg; /* Its argument */
+
+  char *prefix; /* The prefix the elements visited must begin with, or NULL */
+
+  int length; /* The length of the prefix */
+
+  int visited; /* The number of elements passed to `visit` */
+} SCAN;
+
+/* Private function prototypes */
+static POOL *poolOf (SET *set, int type);
+static NODE *newNode (SET *set, int type);
+static void freeNode (SET *set, NODE *node);
+static NODE **findChild (NODE *node, unsigned char c);
+static LEAF *minimumLeaf (NODE *node);
+static int checkPrefix (NODE *node, char *elt, int depth);
+static int prefixMismatch (NODE *node, char *elt, int depth);
+static int addChild (SET *set, NODE **ref, unsigned char c, NODE *child);
+static void removeChild (SET *set, NODE **ref, unsigned char c, NODE **slot);
+static int scanChild (NODE *child, unsigned char c, int depth, char *lo, char *hi, SCAN *scan);
+static int scanNode (NODE *node, int depth, char *lo, char *hi, SCAN *scan);
+
+/*
+ * Function:	poolOf
+ *
+ * Description: Returns the pool of `set` that inner nodes of `type` come from.
+ *
+ * Complexity:  O(1)
+ */
+static POOL *poolOf (SET *set, int type)
+{
+  switch (type) {
+  case 4:
+    return &set->nodes4;
+  case 16:
+    return &set->nodes16;
+  case 48:
+    return &set->nodes48;
+  default:
+    return &set->nodes256;
+  }
+}
+
+/*
+ * Function:	newNode
+ *
+ * Description: Returns a new inner node of `type` with no children and no prefix, or NULL
+ *		if out of memory.
+ *
+ * Complexity:  O(type)
+ */
+static NODE *newNode (SET *set, int type)
+{
+  NODE *node;
+
+  if ((node = allocFromPool (poolOf (set, type))) == NULL)
+    return NULL;
+
+  memset (node, 0, poolOf (set, type)->size);
+
+  node->type = type;
+
+  return node;
+}
+
+/*
+ * Function:	freeNode
+ *
+ * Description: Returns the inner node `node` to its pool.
+ *
+ * Complexity:  O(1)
+ */
+static void freeNode (SET *set, NODE *node)
+{
+  returnToPool (poolOf (set, node->type), node);
+}
+
+/*
+ * Function:	findChild
+ *
+ * Description: Returns the location in `node` of its child for the byte `c`, or NULL if it
+ *		has none.
+ *
+ * Complexity:  O(1)
+ */
+static NODE **findChild (NODE *node, unsigned char c)
+{
+  NODE4 *n4;
+  NODE16 *n16;
+  NODE48 *n48;
+  NODE256 *n256;
+
+  int i;
+
+  switch (node->type) {
+
+  case 4:
+    n4 = (NODE4 *) node;
+    for (i = 0; i < node->count; i++)
+      if (n4->keys[i] == c)
+        return &n4->children[i];
+    return NULL;
+
+  case 16:
+    n16 = (NODE16 *) node;
+# ifdef __SSE2__
+    i = _mm_movemask_epi8 (_mm_cmpeq_epi8 (_mm_set1_epi8 (c),
+                                           _mm_loadu_si128 ((__m128i *) n16->keys)));
+    i &= (1 << node->count) - 1;
+    return i != 0 ? &n16->children[__builtin_ctz (i)] : NULL;
+# else
+    for (i = 0; i < node->count; i++)
+      if (n16->keys[i] == c)
+        return &n16->children[i];
+    return NULL;
+# endif
+
+  case 48:
+    n48 = (NODE48 *) node;
+    return n48->index[c] != 0 ? &n48->children[n48->index[c] - 1] : NULL;
+
+  default:
+    n256 = (NODE256 *) node;
+    return n256->children[c] != NULL ? &n256->children[c] : NULL;
+  }
+}
+
+/*
+ * Function:	minimumLeaf
+ *
+ * Description: Returns the leftmost leaf below `node`, which holds the least element.
+ *
+ * Complexity:  O(k), where k is the length of the element
+ */
+static LEAF *minimumLeaf (NODE *node)
+{
+  int i;
+
+  while (!IS_LEAF (node)) {
+
+    switch (node->type) {
+
+    case 4:
+      node = ((NODE4 *) node)->children[0];
+      break;
+
+    case 16:
+      node = ((NODE16 *) node)->children[0];
+      break;
+
+    case 48:
+      for (i = 0; ((NODE48 *) node)->index[i] == 0; i++)
+        ;
+      node = ((NODE48 *) node)->children[((NODE48 *) node)->index[i] - 1];
+      break;
+
+    default:
+      for (i = 0; ((NODE256 *) node)->children[i] == NULL; i++)
+        ;
+      node = ((NODE256 *) node)->children[i];
+      break;
+    }
+  }
+
+  return TO_LEAF (node);
+}
+
+/*
+ * Function:	checkPrefix
+ *
+ * Description: Returns the number of the bytes of the prefix kept in `node` that `elt`
+ *		matches from `depth` on. A prefix never contains a NUL, so the comparison
+ *		stops at the end of `elt`.
+ *
+ * Complexity:  O(MAX_PREFIX)
+ */
+static int checkPrefix (NODE *node, char *elt, int depth)
+{
+  int i;
+
+  for (i = 0; i < STORED (node); i++)
+    if (node->prefix[i] != (unsigned char) elt[depth + i])
+      break;
+
+  return i;
+}
+
+/*
+ * Function:	prefixMismatch
+ *
+ * Description: Returns the number of bytes of the whole prefix of `node` that `elt`
+ *		matches from `depth` on, reading the bytes not kept in the node from its
+ *		leftmost leaf.
+ *
+ * Complexity:  O(k), where k is the length of the prefix
+ */
+static int prefixMismatch (NODE *node, char *elt, int depth)
+{
+  LEAF *leaf;
+
+  int i;
+
+  i = checkPrefix (node, elt, depth);
+
+  if (i == MAX_PREFIX && node->prefixLength > MAX_PREFIX) {
+
+    leaf = minimumLeaf (node);
+
+    while (i < node->prefixLength && leaf->elt[depth + i] == elt[depth + i])
+      i++;
+  }
+
+  return i;
+}
+
+/*
+ * Function:	addChild
+ *
+ * Description: Adds `child` under the byte `c` to the node at `ref`, which has no child
+ *		for it, and returns whether it succeeded. A full node is first replaced at
+ *		`ref` by a copy of the next size up.
+ *
+ * Complexity:  O(1)
+ */
+static int addChild (SET *set, NODE **ref, unsigned char c, NODE *child)
+{
+  NODE *node = *ref, *grown;
+  NODE4 *n4;
+  NODE16 *n16;
+  NODE48 *n48;
+  NODE256 *n256;
+
+  unsigned char *keys;
+  NODE **children;
+
+  int i, size;
+
+  switch (node->type) {
+
+  case 4:
+  case 16:
+
+    if (node->type == 4) {
+      n4 = (NODE4 *) node;
+      keys = n4->keys;
+      children = n4->children;
+    }
+
+    else {
+      n16 = (NODE16 *) node;
+      keys = n16->keys;
+      children = n16->children;
+    }
+
+    if (node->count < node->type) {
+
+      for (i = 0; i < node->count && keys[i] < c; i++)
+        ;
+
+      memmove (keys + i + 1, keys + i, node->count - i);
+      memmove (children + i + 1, children + i, (node->count - i) * sizeof(NODE *));
+
+      keys[i] = c;
+      children[i] = child;
+      node->count++;
+      return 1;
+    }
+
+    size = node->type == 4 ? 16 : 48;
+
+    if ((grown = newNode (set, size)) == NULL)
+      return 0;
+
+    if (size == 16) {
+      n16 = (NODE16 *) grown;
+      memcpy (n16->keys, keys, node->count);
+      memcpy (n16->children, children, node->count * sizeof(NODE *));
+    }
+
+    else {
+      n48 = (NODE48 *) grown;
+      memcpy (n48->children, children, node->count * sizeof(NODE *));
+      for (i = 0; i < node->count; i++)
+        n48->index[keys[i]] = i + 1;
+    }
+
+    break;
+
+  case 48:
+
+    n48 = (NODE48 *) node;
+
+    if (node->count < 48) {
+
+      for (i = 0; n48->children[i] != NULL; i++)
+        ;
+
+      n48->children[i] = child;
+      n48->index[c] = i + 1;
+      node->count++;
+      return 1;
+    }
+
+    if ((grown = newNode (set, 256)) == NULL)
+      return 0;
+
+    n256 = (NODE256 *) grown;
+
+    for (i = 0; i < 256; i++)
+      if (n48->index[i] != 0)
+        n256->children[i] = n48->children[n48->index[i] - 1];
+
+    break;
+
+  default:
+
+    ((NODE256 *) node)->children[c] = child;
+    node->count++;
+    return 1;
+  }
+
+  grown->count = node->count;
+  grown->prefixLength = node->prefixLength;
+  memcpy (grown->prefix, node->prefix, MAX_PREFIX);
+
+  freeNode (set, node);
+
+  *ref = grown;
+
+  return addChild (set, ref, c, child);
+}
+
+/*
+ * Function:	removeChild
+ *
+ * Description: Removes the child under the byte `c`, at `slot`, from the node at `ref`. A
+ *		node left with few enough children is replaced at `ref` by a copy of the
+ *		next size down, and a node of 4 left with one child is replaced by that
+ *		child, whose prefix takes on the node's prefix and the byte between them.
+ *
+ * Complexity:  O(1)
+ */
+static void removeChild (SET *set, NODE **ref, unsigned char c, NODE **slot)
+{
+  NODE *node = *ref, *shrunk, *child;
+  NODE4 *n4;
+  NODE16 *n16;
+  NODE48 *n48;
+  NODE256 *n256;
+
+  unsigned char *keys;
+  NODE **children;
+
+  int i, j, length;
+
+  switch (node->type) {
+
+  case 4:
+  case 16:
+
+    if (node->type == 4) {
+      n4 = (NODE4 *) node;
+      keys = n4->keys;
+      children = n4->children;
+    }
+
+    else {
+      n16 = (NODE16 *) node;
+      keys = n16->keys;
+      children = n16->children;
+    }
+
+    i = slot - children;
+
+    memmove (keys + i, keys + i + 1, node->count - i - 1);
+    memmove (children + i, children + i + 1, (node->count - i - 1) * sizeof(NODE *));
+
+    node->count--;
+
+    if (node->type == 4 && node->count == 1) {
+
+      child = children[0];
+
+      if (!IS_LEAF (child)) {
+
+        length = node->prefixLength;
+
+        if (length < MAX_PREFIX)
+          node->prefix[length++] = keys[0];
+
+        for (j = 0; length < MAX_PREFIX && j < child->prefixLength; j++)
+          node->prefix[length++] = child->prefix[j];
+
+        memcpy (child->prefix, node->prefix, length < MAX_PREFIX ? length : MAX_PREFIX);
+
+        child->prefixLength += node->prefixLength + 1;
+      }
+
+      freeNode (set, node);
+
+      *ref = child;
+      return;
+    }
+
+    if (node->type == 4 || node->count > 3 || (shrunk = newNode (set, 4)) == NULL)
+      return;
+
+    n4 = (NODE4 *) shrunk;
+    memcpy (n4->keys, keys, node->count);
+    memcpy (n4->children, children, node->count * sizeof(NODE *));
+
+    break;
+
+  case 48:
+
+    n48 = (NODE48 *) node;
+
+    n48->children[n48->index[c] - 1] = NULL;
+    n48->index[c] = 0;
+    node->count--;
+
+    if (node->count > 12 || (shrunk = newNode (set, 16)) == NULL)
+      return;
+
+    n16 = (NODE16 *) shrunk;
+
+    for (i = 0, j = 0; i < 256; i++)
+      if (n48->index[i] != 0) {
+        n16->keys[j] = i;
+        n16->children[j++] = n48->children[n48->index[i] - 1];
+      }
+
+    break;
+
+  default:
+
+    n256 = (NODE256 *) node;
+
+    n256->children[c] = NULL;
+    node->count--;
+
+    if (node->count > 37 || (shrunk = newNode (set, 48)) == NULL)
+      return;
+
+    n48 = (NODE48 *) shrunk;
+
+    for (i = 0, j = 0; i < 256; i++)
+      if (n256->children[i] != NULL) {
+        n48->children[j] = n256->children[i];
+        n48->index[i] = ++j;
+      }
+
+    break;
+  }
+
+  shrunk->count = node->count;
+  shrunk->prefixLength = node->prefixLength;
+  memcpy (shrunk->prefix, node->prefix, MAX_PREFIX);
+
+  freeNode (set, node);
+
+  *ref = shrunk;
+}
+
+/*
+ * Function:	createSet
+ *
+ * Description: Initializes and returns an empty set. The set grows as elements are
+ *		inserted, so `size` is not used.
+ *
+ * Complexity:  O(1)
+ */
+SET *createSet (int size)
+{
+  SET *s;
+
+  s = malloc (sizeof(SET));
+
+  if (s == NULL)
+    return NULL;
+
+  s->count = 0;
+
+  s->root = NULL;
+
+  initPool (&s->leaves, sizeof(LEAF));
+
+  initPool (&s->nodes4, sizeof(NODE4));
+
+  initPool (&s->nodes16, sizeof(NODE16));
+
+  initPool (&s->nodes48, sizeof(NODE48));
+
+  initPool (&s->nodes256, sizeof(NODE256));
+
+  return s;
+}
+
+/*
+ * Function:	numElements
+ *
+ * Description:	Returns the number of elements in `set`.
+ *
+ * Complexity:  O(1)
+ */
+int numElements (SET *set)
+{
+  return set->count;
+}
+
+/*
+ * Function:    hasElement
+ *
+ * Description: Returns whether `elt` is a member of `set`. The prefix bytes not kept in
+ *		a node are skipped unchecked, so the search may pass the end of `elt`, in
+ *		which case it is not present.
+ *
+ * Complexity:  O(k), where k is the length of `elt`
+ */
+int hasElement (SET *set, char *elt)
+{
+  NODE *node, **slot;
+
+  int depth, length;
+
+  node = set->root;
+
+  depth = 0;
+
+  length = strlen (elt);
+
+  while (node != NULL) {
+
+    if (IS_LEAF (node))
+      return strcmp (TO_LEAF (node)->elt, elt) == 0;
+
+    if (node->prefixLength > 0) {
+
+      if (checkPrefix (node, elt, depth) < STORED (node))
+        return 0;
+
+      depth += node->prefixLength;
+
+      if (depth > length)
+        return 0;
+    }
+
+    if ((slot = findChild (node, elt[depth])) == NULL)
+      return 0;
+
+    node = *slot;
+
+    depth++;
+  }
+
+  return 0;
+}
+
+/*
+ * Function:	insertElement
+ *
+ * Description: Inserts `elt` into `set`, and returns whether the set changed. A new leaf
+ *		is added where the search for `elt` leaves the tree. If that is at a leaf,
+ *		or partway through the prefix of a node, a new node of 4 is put there,
+ *		branching at the first byte that differs.
+ *
+ * Complexity:  O(k), where k is the length of `elt`
+ */
+int insertElement (SET *set, char *elt)
+{
+  NODE *node, *split, **ref, **slot;
+  LEAF *leaf, *other;
+
+  unsigned char c;
+
+  int depth, i;
+
+  if ((leaf = allocFromPool (&set->leaves)) == NULL)
+    return 0;
+
+  leaf->elt = elt;
+
+  ref = &set->root;
+
+  depth = 0;
+
+  while ((node = *ref) != NULL) {
+
+    if (IS_LEAF (node)) {
+
+      other = TO_LEAF (node);
+
+      if (strcmp (other->elt, elt) == 0 || (split = newNode (set, 4)) == NULL) {
+        returnToPool (&set->leaves, leaf);
+        return 0;
+      }
+
+      for (i = 0; other->elt[depth + i] == elt[depth + i]; i++)
+        ;
+
+      split->prefixLength = i;
+      memcpy (split->prefix, elt + depth, STORED (split));
+
+      addChild (set, &split, other->elt[depth + i], node);
+      addChild (set, &split, elt[depth + i], FROM_LEAF (leaf));
+
+      *ref = split;
+      set->count++;
+      return 1;
+    }
+
+    if (node->prefixLength > 0) {
+
+      i = prefixMismatch (node, elt, depth);
+
+      if (i < node->prefixLength) {
+
+        if ((split = newNode (set, 4)) == NULL) {
+          returnToPool (&set->leaves, leaf);
+          return 0;
+        }
+
+        split->prefixLength = i;
+        memcpy (split->prefix, node->prefix, STORED (split));
+
+        if (node->prefixLength <= MAX_PREFIX) {
+          c = node->prefix[i];
+          node->prefixLength -= i + 1;
+          memmove (node->prefix, node->prefix + i + 1, STORED (node));
+        }
+
+        else {
+          other = minimumLeaf (node);
+          c = other->elt[depth + i];
+          node->prefixLength -= i + 1;
+          memcpy (node->prefix, other->elt + depth + i + 1, STORED (node));
+        }
+
+        addChild (set, &split, c, node);
+        addChild (set, &split, elt[depth + i], FROM_LEAF (leaf));
+
+        *ref = split;
+        set->count++;
+        return 1;
+      }
+
+      depth += node->prefixLength;
+    }
+
+    if ((slot = findChild (node, elt[depth])) == NULL) {
+
+      if (!addChild (set, ref, elt[depth], FROM_LEAF (leaf))) {
+        returnToPool (&set->leaves, leaf);
+        return 0;
+      }
+
+      set->count++;
+      return 1;
+    }
+
+    ref = slot;
+
+    depth++;
+  }
+
+  *ref = FROM_LEAF (leaf);
+
+  set->count++;
+
+  return 1;
+}
+
+/*
+ * Function:    deleteElement
+ *
+ * Description: Deletes `elt` from `set`, and returns whether the set changed. The leaf
+ *		holding `elt` is removed from its parent, which may then shrink or be
+ *		replaced by its only remaining child.
+ *
+ * Complexity:  O(k), where k is the length of `elt`
+ */
+int deleteElement (SET *set, char *elt)
+{
+  NODE *node, **ref, **slot;
+
+  int depth, length;
+
+  ref = &set->root;
+
+  depth = 0;
+
+  length = strlen (elt);
+
+  if ((node = *ref) == NULL)
+    return 0;
+
+  if (IS_LEAF (node)) {
+
+    if (strcmp (TO_LEAF (node)->elt, elt) != 0)
+      return 0;
+
+    returnToPool (&set->leaves, TO_LEAF (node));
+    set->root = NULL;
+    set->count--;
+    return 1;
+  }
+
+  while (1) {
+
+    if (node->prefixLength > 0) {
+
+      if (checkPrefix (node, elt, depth) < STORED (node))
+        return 0;
+
+      depth += node->prefixLength;
+
+      if (depth > length)
+        return 0;
+    }
+
+    if ((slot = findChild (node, elt[depth])) == NULL)
+      return 0;
+
+    if (IS_LEAF (*slot)) {
+
+      if (strcmp (TO_LEAF (*slot)->elt, elt) != 0)
+        return 0;
+
+      returnToPool (&set->leaves, TO_LEAF (*slot));
+      removeChild (set, ref, elt[depth], slot);
+      set->count--;
+      return 1;
+    }
+
+    ref = slot;
+
+    node = *ref;
+
+    depth++;
+  }
+}
+
+/*
+ * Function:	scanChild
+ *
+ * Description: Scans `child`, which is under the byte `c` at `depth`, unless its elements
+ *		are all less than `lo`, and returns 0 if the scan is over. The bound `lo`
+ *		or `hi` passed on is NULL if no element below `child` can fall outside it.
+ *
+ * Complexity:  O(1), besides the scan of `child`
+ */
+static int scanChild (NODE *child, unsigned char c, int depth, char *lo, char *hi, SCAN *scan)
+{
+  if (lo != NULL) {
+
+    if (c < (unsigned char) lo[depth])
+      return 1;
+
+    if (c > (unsigned char) lo[depth])
+      lo = NULL;
+  }
+
+  if (hi != NULL) {
+
+    if (c > (unsigned char) hi[depth])
+      return 0;
+
+    if (c < (unsigned char) hi[depth])
+      hi = NULL;
+  }
+
+  return scanNode (child, depth + 1, lo, hi, scan);
+}
+
+/*
+ * Function:	scanNode
+ *
+ * Description: Passes the elements below `node`, whose prefix starts at `depth`, that are
+ *		not less than `lo` and are less than `hi` to the callback of `scan` in
+ *		sorted order, and returns 0 if the scan is over. A NULL bound is one that
+ *		every element below `node` is known to satisfy, so only the nodes along
+ *		the paths to the bounds compare bytes with them.
+ *
+ * Complexity:  O(k + m), where k is the number of elements visited and m the length of
+ *		the bounds
+ */
+static int scanNode (NODE *node, int depth, char *lo, char *hi, SCAN *scan)
+{
+  NODE48 *n48;
+  NODE256 *n256;
+
+  char *elt, *full;
+
+  unsigned char b;
+
+  int i;
+
+  if (IS_LEAF (node)) {
+
+    elt = TO_LEAF (node)->elt;
+
+    if (lo != NULL && strcmp (elt, lo) < 0)
+      return 1;
+
+    if (hi != NULL && strcmp (elt, hi) >= 0)
+      return 0;
+
+    if (scan->prefix != NULL && strncmp (elt, scan->prefix, scan->length) != 0)
+      return 0;
+
+    scan->visited++;
+
+    return scan->visit (elt, scan->arg);
+  }
+
+  full = node->prefixLength > MAX_PREFIX ? minimumLeaf (node)->elt + depth : NULL;
+
+  for (i = 0; i < node->prefixLength && (lo != NULL || hi != NULL); i++) {
+
+    b = i < MAX_PREFIX ? node->prefix[i] : (unsigned char) full[i];
+
+    if (lo != NULL) {
+
+      if (b < (unsigned char) lo[depth + i])
+        return 1;
+
+      if (b > (unsigned char) lo[depth + i])
+        lo = NULL;
+    }
+
+    if (hi != NULL) {
+
+      if (b > (unsigned char) hi[depth + i])
+        return 0;
+
+      if (b < (unsigned char) hi[depth + i])
+        hi = NULL;
+    }
+  }
+
+  depth += node->prefixLength;
+
+  switch (node->type) {
+
+  case 4:
+    for (i = 0; i < node->count; i++)
+      if (!scanChild (((NODE4 *) node)->children[i], ((NODE4 *) node)->keys[i], depth, lo, hi, scan))
+        return 0;
+    break;
+
+  case 16:
+    for (i = 0; i < node->count; i++)
+      if (!scanChild (((NODE16 *) node)->children[i], ((NODE16 *) node)->keys[i], depth, lo, hi, scan))
+        return 0;
+    break;
+
+  case 48:
+    n48 = (NODE48 *) node;
+    for (i = 0; i < 256; i++)
+      if (n48->index[i] != 0 && !scanChild (n48->children[n48->index[i] - 1], i, depth, lo, hi, scan))
+        return 0;
+    break;
+
+  default:
+    n256 = (NODE256 *) node;
+    for (i = 0; i < 256; i++)
+      if (n256->children[i] != NULL && !scanChild (n256->children[i], i, depth, lo, hi, scan))
+        return 0;
+    break;
+  }
+
+  return 1;
+}
+
+/*
+ * Function:	rangeScan
+ *
+ * Description: Passes each element of `set` that is not less than `lo` and is less than
+ *		`hi` to `visit` in sorted order, along with `arg`, and returns the number
+ *		of elements visited. A NULL bound leaves that end of the range open. The
+ *		scan stops early once `visit` returns 0. The set must not be changed during
+ *		the scan.
+ *
+ * Complexity:  O(k + m), where k is the number of elements visited and m the length of
+ *		the bounds
+ */
+int rangeScan (SET *set, char *lo, char *hi, int (*visit) (char *elt, void *arg), void *arg)
+{
+  SCAN scan;
+
+  scan.visit = visit;
+
+  scan.arg = arg;
+
+  scan.prefix = NULL;
+
+  scan.visited = 0;
+
+  if (set->root != NULL)
+    scanNode (set->root, 0, lo, hi, &scan);
+
+  return scan.visited;
+}
+
+/*
+ * Function:	prefixScan
+ *
+ * Description: Passes each element of `set` that begins with `prefix` to `visit` in sorted
+ *		order, along with `arg`, and returns the number of elements visited. The
+ *		elements with a prefix follow one another from the prefix itself, so the
+ *		scan starts there and ends at the first element without it. As with
+ *		rangeScan, the scan stops early once `visit` returns 0.
+ *
+ * Complexity:  O(k + m), where k is the number of elements visited and m the length of
+ *		the prefix
+ */
+int prefixScan (SET *set, char *prefix, int (*visit) (char *elt, void *arg), void *arg)
+{
+  SCAN scan;
+
+  scan.visit = visit;
+
+  scan.arg = arg;
+
+  scan.prefix = prefix;
+
+  scan.length = strlen (prefix);
+
+  scan.visited = 0;
+
+  if (set->root != NULL)
+    scanNode (set->root, 0, prefix, NULL, &scan);
+
+  return scan.visited;
+}
+
+/*
+ * Function:    destroySet
+ *
+ * Description: Deallocates memory associated with `set`. The nodes and leaves are freed
+ *		a slab at a time by releasing the pools.
+ *
+ * Complexity:  O(n/POOL_LIMIT)
+ */
+void destroySet (SET *set)
+{
+  releasePool (&set->leaves);
+
+  releasePool (&set->nodes4);
+
+  releasePool (&set->nodes16);
+
+  releasePool (&set->nodes48);
+
+  releasePool (&set->nodes256);
+
+  free (set);
+
+  return;
+}
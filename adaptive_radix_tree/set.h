@@ -0,0 +1,27 @@
+/*
+ * File:	set.h
+ *
+ * Description:	This file contains the specification of the structure and function prototypes
+ *              for a set abstract data type.
+ *
+ *              A set is an unordered collection of unique elements. Each element is a string.
+ *
+ */
+
+typedef struct set SET;
+
+SET *createSet (int size);
+
+void destroySet (SET *set);
+
+int numElements (SET *set);
+
+int hasElement (SET *set, char *elt);
+
+int insertElement (SET *set, char *elt);
+
+int deleteElement (SET *set, char *elt);
+
+int rangeScan (SET *set, char *lo, char *hi, int (*visit) (char *elt, void *arg), void *arg);
+
+int prefixScan (SET *set, char *prefix, int (*visit) (char *elt, void *arg), void *arg);
@@ -0,0 +1,811 @@
+/*
+ * File:		list.c
+ *
+ * Description:	This file contains the public and private function definitions for a list abstract
+ *		data type in the form of a B+ tree.  Items are stored in sorted order in the leaves,
+ *		each of which holds up to ORDER of them, and the leaves are linked in order so that a
+ *		range of items is read off one leaf after another.  Each inner node holds up to ORDER
+ *		separators and one more child than separators; every item in the subtree before a
+ *		separator is less than it, and every item in the subtree after it is not.  Items are
+ *		unique: inserting one already present leaves the list unchanged.
+ *
+ *		Every node but the root is kept at least half full.  A full node is split in two on
+ *		insertion, and a node left less than half full by a deletion takes an item from a
+ *		neighbour, or is merged with it if the neighbour has none to spare.  The tree is
+ *		therefore about log base ORDER/2 to ORDER of n nodes high, so a search visits a few
+ *		wide nodes rather than a long path of single items.
+ *
+ *		Each node also keeps the first eight bytes of each of its keys as an integer (see
+ *		../common/prefix.h), in an array of its own.  A search within a node counts the
+ *		prefixes less than the one sought, which reads a few consecutive cache lines and
+ *		no strings, and compares strings only for keys whose prefixes tie with it.
+ *
+ *		Leaves and inner nodes come from two pools owned by the list (see ../common/pool.h),
+ *		leaves being allocated without the children array they do not use.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <string.h>
+#include "list.h"
+#include "../common/pool.h"
+#include "../common/prefix.h"
+#include "../common/prefetch.h"
+
+#define ORDER 64			//The most keys in a node
+#define MIN_KEYS (ORDER / 2)		//The fewest keys in a node other than the root
+#define MAX_DEPTH 16			//No tree of fewer than 2^31 items is deeper
+
+/* Datatype declarations: */
+
+typedef struct node {
+
+  int leaf;				//Whether the node is a leaf
+
+  int count;				//The number of keys
+
+  struct node *next;			//The next leaf in order, in a leaf
+
+  unsigned long long prefixes[ORDER + 1];	//The prefixes of the keys, with room for one
+					//more until a full node is split
+
+  char *keys[ORDER + 1];		//The items in a leaf, the separators in an inner node
+
+  struct node *children[ORDER + 2];	//The subtrees around the separators, in an inner node
+
+} NODE;
+
+struct list {
+
+  int count;
+
+  NODE *root;
+
+  POOL leaves;				//The leaves, allocated without their children
+
+  POOL inners;				//The inner nodes
+};
+
+/* Private function prototypes: */
+
+static NODE *newNode (LIST *list, int leaf);
+
+static void freeNode (LIST *list, NODE *node);
+
+static void prefetchNode (NODE *node);
+
+static int searchNode (NODE *node, char *item, unsigned long long prefix, int *found);
+
+static NODE *findLeaf (LIST *list, char *item, unsigned long long prefix, NODE **path, int *slots, int *depth);
+
+static void moveKeys (NODE *dst, int i, NODE *src, int j, int n);
+
+static NODE *splitNode (NODE *node, NODE *right, char **key, unsigned long long *prefix);
+
+static void addKey (NODE *node, int i, char *key, unsigned long long prefix, NODE *child);
+
+static void removeKey (NODE *node, int i);
+
+static void shiftRight (NODE *parent, int i);
+
+static void shiftLeft (NODE *parent, int i);
+
+static void joinNodes (LIST *list, NODE *parent, int i);
+
+
+/*
+ *Function:	newNode
+ *
+ *Description:	Allocates an empty leaf or inner node from the pools of "list," or returns NULL if
+ *		out of memory
+ *
+ *Complexity:	O(1)
+ *
+ */
+
+static NODE *newNode (LIST *list, int leaf) {
+
+  NODE *node;
+
+  if ((node = allocFromPool (leaf ? &list->leaves : &list->inners)) == NULL)
+
+    return NULL;
+
+  node->leaf = leaf;
+
+  node->count = 0;
+
+  node->next = NULL;
+
+  return node;
+}
+
+
+/*
+ *Function:	freeNode
+ *
+ *Description:	Returns "node" to the pool of "list" it came from
+ *
+ *Complexity:	O(1)
+ *
+ */
+
+static void freeNode (LIST *list, NODE *node) {
+
+  returnToPool (node->leaf ? &list->leaves : &list->inners, node);
+}
+
+
+/*
+ *Function:	createList
+ *
+ *Description:	Creates, initializes, and returns a list, whose root is an empty leaf
+ *
+ *Complexity:	O(1)
+ *
+ */
+
+LIST *createList (void) {
+
+  LIST *list;
+
+  if ((list = malloc (sizeof(LIST))) == NULL)
+
+    return NULL;
+
+  list->count = 0;
+
+  initPool (&list->leaves, offsetof(NODE, children));
+
+  initPool (&list->inners, sizeof(NODE));
+
+  if ((list->root = newNode (list, 1)) == NULL) {
+
+    free (list);
+
+    return NULL;
+  }
+
+  return list;
+}
+
+
+/*
+ *Function:	destroyList
+ *
+ *Description:	Deallocates memory associated with "list".  The nodes are freed a slab at a
+ *		time by releasing the pools.  The items themselves belong to the caller.
+ *
+ *Complexity:	O(n/(ORDER*POOL_LIMIT))
+ *
+ */
+
+void destroyList (LIST *list) {
+
+  releasePool (&list->leaves);
+
+  releasePool (&list->inners);
+
+  free (list);
+}
+
+
+/*
+ *Function:	numItems
+ *
+ *Description:	Returns the number of items in "list"
+ *
+ *Complexity:	O(1)
+ *
+ */
+
+int numItems (LIST *list) {
+
+  return list->count;
+}
+
+
+/*
+ *Function:	prefetchNode
+ *
+ *Description:	Starts loading the cache lines holding the count and the prefixes of "node," so
+ *		that a search of it waits for one miss rather than one per line
+ *
+ *Complexity:	O(1)
+ *
+ */
+
+static void prefetchNode (NODE *node) {
+
+  char *line;
+
+  for (line = (char *) node; line < (char *) (node->prefixes + ORDER); line += 64)
+
+    PREFETCH (line);
+}
+
+
+/*
+ *Function:	searchNode
+ *
+ *Description:	Returns the number of keys of "node" less than "item," whose prefix is "prefix,"
+ *		which is the position of "item" among them, and sets "found" to whether the key
+ *		there equals it.  The prefixes less than "prefix" are counted without branching;
+ *		the keys whose prefixes equal it, which follow them, are then compared as strings.
+ *
+ *Complexity:	O(ORDER)
+ *
+ */
+
+static int searchNode (NODE *node, char *item, unsigned long long prefix, int *found) {
+
+  int i, pos = 0, diff;
+
+  for (i = 0; i < node->count; i++)
+
+    pos += node->prefixes[i] < prefix;
+
+  *found = 0;
+
+  while (pos < node->count && node->prefixes[pos] == prefix) {
+
+    diff = strcmp (node->keys[pos], item);
+
+    if (diff >= 0) {
+
+      *found = diff == 0;
+
+      break;
+    }
+
+    pos++;
+  }
+
+  return pos;
+}
+
+
+/*
+ *Function:	findLeaf
+ *
+ *Description:	Returns the leaf of "list" that holds "item," whose prefix is "prefix," or would
+ *		hold it.  Unless "path" is NULL, the inner nodes passed through are recorded on it
+ *		from the root down, with the child taken from each in "slots," and "depth" is set
+ *		to their number.
+ *
+ *Complexity:	O(logn)
+ *
+ */
+
+static NODE *findLeaf (LIST *list, char *item, unsigned long long prefix, NODE **path, int *slots, int *depth) {
+
+  NODE *node;
+
+  int slot, found, d = 0;
+
+  node = list->root;
+
+  while (!node->leaf) {
+
+    slot = searchNode (node, item, prefix, &found);
+
+    slot += found;				//A separator equal to the item leads right
+
+    if (path) {
+
+      path[d] = node;
+
+      slots[d++] = slot;
+    }
+
+    node = node->children[slot];
+
+    prefetchNode (node);
+  }
+
+  if (path)
+
+    *depth = d;
+
+  return node;
+}
+
+
+/*
+ *Function:	hasItem
+ *
+ *Description:	Returns one if "item" is present in "list," and zero otherwise
+ *
+ *Complexity:	O(logn)
+ *
+ */
+
+int hasItem (LIST *list, char *item) {
+
+  unsigned long long prefix;
+
+  int found;
+
+  prefix = prefixOf (item);
+
+  searchNode (findLeaf (list, item, prefix, NULL, NULL, NULL), item, prefix, &found);
+
+  return found;
+}
+
+
+/*
+ *Function:	moveKeys
+ *
+ *Description:	Moves "n" keys and their prefixes from position "j" of "src" to position "i" of
+ *		"dst," which may be the same node
+ *
+ *Complexity:	O(n)
+ *
+ */
+
+static void moveKeys (NODE *dst, int i, NODE *src, int j, int n) {
+
+  memmove (dst->keys + i, src->keys + j, n * sizeof(char *));
+
+  memmove (dst->prefixes + i, src->prefixes + j, n * sizeof(unsigned long long));
+}
+
+
+/*
+ *Function:	addKey
+ *
+ *Description:	Inserts "key," whose prefix is "prefix," at position "i" of "node," and in an inner
+ *		node "child" after it, as the subtree of the keys not less than it
+ *
+ *Complexity:	O(ORDER)
+ *
+ */
+
+static void addKey (NODE *node, int i, char *key, unsigned long long prefix, NODE *child) {
+
+  moveKeys (node, i + 1, node, i, node->count - i);
+
+  node->keys[i] = key;
+
+  node->prefixes[i] = prefix;
+
+  if (!node->leaf) {
+
+    memmove (node->children + i + 2, node->children + i + 1, (node->count - i) * sizeof(NODE *));
+
+    node->children[i + 1] = child;
+  }
+
+  node->count++;
+}
+
+
+/*
+ *Function:	removeKey
+ *
+ *Description:	Removes the key at position "i" of "node," and in an inner node the child after it
+ *
+ *Complexity:	O(ORDER)
+ *
+ */
+
+static void removeKey (NODE *node, int i) {
+
+  moveKeys (node, i, node, i + 1, node->count - i - 1);
+
+  if (!node->leaf)
+
+    memmove (node->children + i + 1, node->children + i + 2, (node->count - i - 1) * sizeof(NODE *));
+
+  node->count--;
+}
+
+
+/*
+ *Function:	splitNode
+ *
+ *Description:	Moves the upper half of "node," which has one key too many, to the empty node
+ *		"right," and returns it, setting "key" and "prefix" to the separator between them.
+ *		A leaf keeps its first MIN_KEYS items and is linked to "right," whose first item is
+ *		the separator.  An inner node keeps its first MIN_KEYS separators and gives up the
+ *		next one to its parent.
+ *
+ *Complexity:	O(ORDER)
+ *
+ */
+
+static NODE *splitNode (NODE *node, NODE *right, char **key, unsigned long long *prefix) {
+
+  if (node->leaf) {
+
+    right->count = node->count - MIN_KEYS;
+
+    moveKeys (right, 0, node, MIN_KEYS, right->count);
+
+    right->next = node->next;
+
+    node->next = right;
+
+    *key = right->keys[0];
+
+    *prefix = right->prefixes[0];
+  }
+
+  else {
+
+    right->count = node->count - MIN_KEYS - 1;
+
+    moveKeys (right, 0, node, MIN_KEYS + 1, right->count);
+
+    memcpy (right->children, node->children + MIN_KEYS + 1, (right->count + 1) * sizeof(NODE *));
+
+    *key = node->keys[MIN_KEYS];
+
+    *prefix = node->prefixes[MIN_KEYS];
+  }
+
+  node->count = MIN_KEYS;
+
+  return right;
+}
+
+
+/*
+ *Function:	insertItem
+ *
+ *Description:	Inserts "item" into its leaf, and returns whether list changed, which it does not
+ *		if "item" is already present.  A leaf that overflows is split, as is each parent
+ *		that overflows with the new separator, and a new root is added above a split root.
+ *		The nodes this needs are allocated first, so running out of memory leaves the list
+ *		unchanged.
+ *
+ *Complexity:	O(logn)
+ *
+ */
+
+int insertItem (LIST *list, char *item) {
+
+  NODE *path[MAX_DEPTH], *spare[MAX_DEPTH + 1], *node, *root;
+
+  unsigned long long prefix;
+
+  int slots[MAX_DEPTH], depth, d, pos, found, need, i;
+
+  char *key;
+
+  prefix = prefixOf (item);
+
+  node = findLeaf (list, item, prefix, path, slots, &depth);
+
+  pos = searchNode (node, item, prefix, &found);
+
+  if (found)
+
+    return 0;
+
+  for (need = 0; need <= depth; need++)		//Count the full nodes that will split
+
+    if ((need == 0 ? node : path[depth - need])->count < ORDER)
+
+      break;
+
+  for (i = 0; i < need + (need > depth); i++)	//Plus a new root if the root splits
+
+    if ((spare[i] = newNode (list, i == 0)) == NULL) {
+
+      while (i-- > 0)
+
+	freeNode (list, spare[i]);
+
+      return 0;
+    }
+
+  addKey (node, pos, item, prefix, NULL);
+
+  for (d = depth, i = 0; node->count > ORDER; d--, i++) {
+
+    splitNode (node, spare[i], &key, &prefix);
+
+    if (d == 0) {				//The root split: grow a level
+
+      root = spare[i + 1];
+
+      root->count = 1;
+
+      root->keys[0] = key;
+
+      root->prefixes[0] = prefix;
+
+      root->children[0] = node;
+
+      root->children[1] = spare[i];
+
+      list->root = root;
+
+      break;
+    }
+
+    node = path[d - 1];
+
+    addKey (node, slots[d - 1], key, prefix, spare[i]);
+  }
+
+  list->count++;
+
+  return 1;
+}
+
+
+/*
+ *Function:	shiftRight
+ *
+ *Description:	Moves the last key of child "i" of "parent" to the front of child "i + 1," and
+ *		updates the separator between them
+ *
+ *Complexity:	O(ORDER)
+ *
+ */
+
+static void shiftRight (NODE *parent, int i) {
+
+  NODE *left = parent->children[i], *right = parent->children[i + 1];
+
+  moveKeys (right, 1, right, 0, right->count);
+
+  if (left->leaf) {
+
+    moveKeys (right, 0, left, left->count - 1, 1);
+
+    moveKeys (parent, i, right, 0, 1);
+  }
+
+  else {
+
+    memmove (right->children + 1, right->children, (right->count + 1) * sizeof(NODE *));
+
+    right->children[0] = left->children[left->count];
+
+    moveKeys (right, 0, parent, i, 1);
+
+    moveKeys (parent, i, left, left->count - 1, 1);
+  }
+
+  left->count--;
+
+  right->count++;
+}
+
+
+/*
+ *Function:	shiftLeft
+ *
+ *Description:	Moves the first key of child "i + 1" of "parent" to the end of child "i," and
+ *		updates the separator between them
+ *
+ *Complexity:	O(ORDER)
+ *
+ */
+
+static void shiftLeft (NODE *parent, int i) {
+
+  NODE *left = parent->children[i], *right = parent->children[i + 1];
+
+  if (left->leaf) {
+
+    moveKeys (left, left->count, right, 0, 1);
+
+    moveKeys (right, 0, right, 1, right->count - 1);
+
+    moveKeys (parent, i, right, 0, 1);
+  }
+
+  else {
+
+    moveKeys (left, left->count, parent, i, 1);
+
+    left->children[left->count + 1] = right->children[0];
+
+    moveKeys (parent, i, right, 0, 1);
+
+    moveKeys (right, 0, right, 1, right->count - 1);
+
+    memmove (right->children, right->children + 1, right->count * sizeof(NODE *));
+  }
+
+  left->count++;
+
+  right->count--;
+}
+
+
+/*
+ *Function:	joinNodes
+ *
+ *Description:	Merges child "i + 1" of "parent" into child "i," along with the separator between
+ *		them if they are inner nodes, and removes it and the separator from "parent"
+ *
+ *Complexity:	O(ORDER)
+ *
+ */
+
+static void joinNodes (LIST *list, NODE *parent, int i) {
+
+  NODE *left = parent->children[i], *right = parent->children[i + 1];
+
+  if (left->leaf)
+
+    left->next = right->next;
+
+  else {
+
+    moveKeys (left, left->count++, parent, i, 1);
+
+    memcpy (left->children + left->count, right->children, (right->count + 1) * sizeof(NODE *));
+  }
+
+  moveKeys (left, left->count, right, 0, right->count);
+
+  left->count += right->count;
+
+  freeNode (list, right);
+
+  removeKey (parent, i);
+}
+
+
+/*
+ *Function:	deleteItem
+ *
+ *Description:	Deletes "item" from its leaf, and returns whether the list changed.  Each node
+ *		left less than half full, from the leaf up, takes a key from a neighbour that can
+ *		spare one, or else is merged with it, which takes a separator from their parent.
+ *		A root left with no separators is replaced by its only child.  The item itself
+ *		belongs to the caller and is not freed.
+ *
+ *		Since the caller may free the item once it is deleted, it must not be left behind
+ *		as a separator.  Each separator is the first item of the subtree after it, so the
+ *		item is one only if it was first in its leaf, and then only in the nearest node on
+ *		the path where the search went right of a separator.  That separator is replaced
+ *		with the new first item of the leaf before the tree is rebalanced, which moves it
+ *		only as a whole.
+ *
+ *Complexity:	O(logn)
+ *
+ */
+
+int deleteItem (LIST *list, char *item) {
+
+  NODE *path[MAX_DEPTH], *node, *parent;
+
+  unsigned long long prefix;
+
+  int slots[MAX_DEPTH], depth, pos, found, slot, d;
+
+  char *key;
+
+  prefix = prefixOf (item);
+
+  node = findLeaf (list, item, prefix, path, slots, &depth);
+
+  pos = searchNode (node, item, prefix, &found);
+
+  if (!found)
+
+    return 0;
+
+  key = node->keys[pos];
+
+  removeKey (node, pos);
+
+  for (d = depth; pos == 0 && d-- > 0; )	//Replace the item as a separator
+
+    if (slots[d] > 0) {
+
+      if (path[d]->keys[slots[d] - 1] == key)
+
+	moveKeys (path[d], slots[d] - 1, node, 0, 1);
+
+      break;
+    }
+
+  while (depth > 0 && node->count < MIN_KEYS) {
+
+    parent = path[--depth];
+
+    slot = slots[depth];
+
+    if (slot > 0 && parent->children[slot - 1]->count > MIN_KEYS)
+
+      shiftRight (parent, slot - 1);
+
+    else if (slot < parent->count && parent->children[slot + 1]->count > MIN_KEYS)
+
+      shiftLeft (parent, slot);
+
+    else
+
+      joinNodes (list, parent, slot > 0 ? slot - 1 : slot);
+
+    node = parent;
+  }
+
+  if (!list->root->leaf && list->root->count == 0) {	//Shrink a level
+
+    node = list->root;
+
+    list->root = node->children[0];
+
+    freeNode (list, node);
+  }
+
+  list->count--;
+
+  return 1;
+}
+
+
+/*
+ *Function:	rangeItems
+ *
+ *Description:	Passes each item of "list" that is not less than "lo" and is less than "hi" to
+ *		"visit" in sorted order, along with "arg", and returns the number of items visited.
+ *		A NULL bound leaves that end of the range open. The traversal stops early once
+ *		"visit" returns zero. The list must not be changed during the traversal.
+ *
+ *		The traversal descends once to the leaf holding "lo," then follows the links from
+ *		leaf to leaf.  Each item is checked against "hi" by its prefix, and as a string
+ *		only when the prefixes are equal.
+ *
+ *Complexity:	O(logn + k), where k is the number of items visited
+ *
+ */
+
+int rangeItems (LIST *list, char *lo, char *hi, int (*visit) (char *item, void *arg), void *arg) {
+
+  NODE *leaf;
+
+  unsigned long long prefix, limit;
+
+  int i, found, visited = 0;
+
+  if (lo) {
+
+    prefix = prefixOf (lo);
+
+    leaf = findLeaf (list, lo, prefix, NULL, NULL, NULL);
+
+    i = searchNode (leaf, lo, prefix, &found);
+  }
+
+  else {
+
+    for (leaf = list->root; !leaf->leaf; leaf = leaf->children[0])
+
+      ;
+
+    i = 0;
+  }
+
+  limit = hi ? prefixOf (hi) : 0;
+
+  for (; leaf; leaf = leaf->next, i = 0)
+
+    for (; i < leaf->count; i++) {
+
+      if (hi && (leaf->prefixes[i] > limit ||
+		 (leaf->prefixes[i] == limit && strcmp (leaf->keys[i], hi) >= 0)))
+
+	return visited;
+
+      visited++;
+
+      if (!visit (leaf->keys[i], arg))
+
+	return visited;
+    }
+
+  return visited;
+}
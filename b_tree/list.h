@@ -0,0 +1,25 @@
+/*
+ * File: list.h
+ *
+ * Description: This file contains the public function type declarations for a list
+ *		abstract data type for strings.  A list is an ordered collection of
+ *		elements.  Unlike the list in ../binary_search_tree, this one holds
+ *		no duplicates: inserting an item already present fails.
+ *
+ */
+
+typedef struct list LIST;
+
+LIST *createList (void);
+
+void destroyList (LIST *list);
+
+int numItems (LIST *list);
+
+int hasItem (LIST *list, char *item);
+
+int insertItem (LIST *list, char *item);
+
+int deleteItem (LIST *list, char *item);
+
+int rangeItems (LIST *list, char *lo, char *hi, int (*visit) (char *item, void *arg), void *arg);
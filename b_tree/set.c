@@ -0,0 +1,214 @@
+/*
+ * File:		set.c
+ *
+ * Description:	This file contains the function definitions for a set abstract datatype for strings.
+ *
+ *              This implementation relies on a list abstract datatype (which happens to be in the form of a
+ *              B+ tree, see list.c) to store elements.  The list keeps its items unique and in
+ *              sorted order, so each operation on the set is one operation on the list.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "list.h"
+#include "set.h"
+
+/*Datatype declaration(s): */
+
+struct set {
+
+  LIST *list;
+};
+
+typedef struct prefix {		//State of a prefix scan, passed through rangeItems
+
+  char *prefix;
+
+  int length;
+
+  int (*visit) (char *elt, void *arg);
+
+  void *arg;
+
+  int visited;			//The number of elements passed to "visit"
+
+} PREFIX;
+
+/*Private function prototypes: */
+
+static int visitPrefixed (char *elt, void *arg);
+
+/*
+ *Function:	createSet
+ *
+ *Description:	Creates, initializes and returns a set.  The set grows as elements are inserted,
+ *		so "size" is not used
+ *
+ *Complexity:	O(1)
+ *
+ */
+
+SET *createSet (int size) {
+
+  SET *set;
+
+  if ((set = malloc (sizeof(SET))) == NULL)
+
+    return NULL;
+
+  if ((set->list = createList()) == NULL) {
+
+    free (set);
+
+    return NULL;
+  }
+
+  return set;
+}
+
+
+/*
+ *Function:	destroySet
+ *
+ *Description:	Deallocates memory associated with "set"
+ *
+ *Complexity:	O(n/(ORDER*POOL_LIMIT)), see list.c
+ */
+
+void destroySet (SET *set) {
+
+  destroyList (set->list);
+
+  free (set);
+}
+
+
+/*
+ *Function:	numElements
+ *
+ *Description:	Returns the number of elements in "set"
+ *
+ *Complexity:	O(1)
+ *
+ */
+
+int numElements (SET *set) {
+
+  return numItems (set->list);
+}
+
+
+/*
+ *Function:	hasElement
+ *
+ *Description:	Returns 1 if "elt" is present in "set," and zero otherwise
+ *
+ *Complexity:	O(logn)
+ */
+
+int hasElement (SET *set, char *elt) {
+
+  return hasItem (set->list, elt);
+}
+
+
+/*
+ *Function:	insertElement
+ *
+ *Description:	Inserts "elt" into "set," and returns whether the set changed
+ *
+ *Complexity:	O(logn)
+ */
+
+int insertElement (SET *set, char *elt) {
+
+  return insertItem (set->list, elt);
+}
+
+
+/*
+ *Function:	deleteElement
+ *
+ *Description:	Removes "elt" from "set," and returns whether the set changed
+ *
+ *Complexity:	O(logn)
+ */
+
+int deleteElement (SET *set, char *elt) {
+
+  return deleteItem (set->list, elt);
+}
+
+
+/*
+ *Function:	rangeScan
+ *
+ *Description:	Passes each element of "set" that is not less than "lo" and is less than "hi" to
+ *		"visit" in sorted order, along with "arg", and returns the number of elements
+ *		visited. A NULL bound leaves that end of the range open. The scan stops early
+ *		once "visit" returns zero. The set must not be changed during the scan.
+ *
+ *Complexity:	O(logn + k), where k is the number of elements visited
+ */
+
+int rangeScan (SET *set, char *lo, char *hi, int (*visit) (char *elt, void *arg), void *arg) {
+
+  return rangeItems (set->list, lo, hi, visit, arg);
+}
+
+
+/*
+ *Function:	visitPrefixed
+ *
+ *Description:	Passes "elt" on to the callback of the prefix scan "arg" if it begins with the
+ *		prefix, and returns zero to end the traversal at the first element that does not.
+ *
+ *Complexity:	O(m), where m is the length of the prefix
+ */
+
+static int visitPrefixed (char *elt, void *arg) {
+
+  PREFIX *scan = arg;
+
+  if (strncmp (elt, scan->prefix, scan->length) != 0)
+
+    return 0;
+
+  scan->visited++;
+
+  return scan->visit (elt, scan->arg);
+}
+
+
+/*
+ *Function:	prefixScan
+ *
+ *Description:	Passes each element of "set" that begins with "prefix" to "visit" in sorted order,
+ *		along with "arg", and returns the number of elements visited. The elements with a
+ *		prefix follow one another from the prefix itself, so the traversal starts there
+ *		and ends at the first element without it. As with rangeScan, the scan stops early
+ *		once "visit" returns zero.
+ *
+ *Complexity:	O(logn + k), where k is the number of elements visited
+ */
+
+int prefixScan (SET *set, char *prefix, int (*visit) (char *elt, void *arg), void *arg) {
+
+  PREFIX scan;
+
+  scan.prefix = prefix;
+
+  scan.length = strlen (prefix);
+
+  scan.visit = visit;
+
+  scan.arg = arg;
+
+  scan.visited = 0;
+
+  rangeItems (set->list, prefix, NULL, visitPrefixed, &scan);
+
+  return scan.visited;
+}
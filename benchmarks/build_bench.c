@@ -0,0 +1,127 @@
+/*
+ * File:	build_bench.c
+ *
+ * Description:	This file contains a benchmark comparing building a set one insertion
+ *		at a time with building it by createSetFromArray on several threads. It
+ *		can be built against any implementation that offers createSetFromArray.
+ *
+ *		The program takes a file of words and an optional maximum number of
+ *		threads (by default 4). All words are read into memory first. A set is
+ *		then built by inserting every word that is not yet present, the way
+ *		each main.c does, and again by createSetFromArray for every thread
+ *		count from one up to the maximum. The build time per word and the
+ *		number of elements, which must always be the same, are printed.
+ *
+ *		Usage: gcc -O2 -pthread -I../hash_table build_bench.c ../hash_table/set.c
+ *		       ./a.out words.txt [threads]
+ *
+ *		For an implementation built on a list, compile its list.c as well.
+ *
+ */
+
+# include <stdio.h>
+# include <stdlib.h>
+# include <string.h>
+# include <time.h>
+# include "set.h"
+
+
+/*
+ * Function:	now
+ *
+ * Description:	Returns the current time in seconds.
+ */
+
+static double now (void)
+{
+    struct timespec ts;
+
+    clock_gettime (CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+
+/*
+ * Function:	main
+ *
+ * Description:	Driver function for the benchmark.
+ */
+
+int main (int argc, char *argv [])
+{
+    FILE *fp;
+    char buffer [BUFSIZ];
+    char **words;
+    int i, n, max, threads, maxThreads;
+    double start, secs;
+    SET *set;
+
+    if (argc < 2 || argc > 3) {
+	fprintf (stderr, "usage: %s words [threads]\n", argv [0]);
+	exit (EXIT_FAILURE);
+    }
+
+    if ((fp = fopen (argv [1], "r")) == NULL) {
+	fprintf (stderr, "%s: cannot open %s\n", argv [0], argv [1]);
+	exit (EXIT_FAILURE);
+    }
+
+    n = 0;
+    max = 1024;
+    words = malloc (max * sizeof (char *));
+
+    while (words != NULL && fscanf (fp, "%s", buffer) == 1) {
+	if (n == max)
+	    words = realloc (words, (max *= 2) * sizeof (char *));
+	if (words != NULL && (words [n] = strdup (buffer)) != NULL)
+	    n ++;
+    }
+
+    fclose (fp);
+
+    if (words == NULL || n == 0) {
+	fprintf (stderr, "%s: no words or out of memory\n", argv [0]);
+	exit (EXIT_FAILURE);
+    }
+
+    maxThreads = argc == 3 ? atoi (argv [2]) : 4;
+
+    printf ("%d words\n", n);
+    printf ("build            ns/word   elements\n");
+
+
+    /* Build the set one insertion at a time. */
+
+    start = now ();
+
+    if ((set = createSet (n)) == NULL) {
+	fprintf (stderr, "%s: failed to create set\n", argv [0]);
+	exit (EXIT_FAILURE);
+    }
+
+    for (i = 0; i < n; i ++)
+	if (!hasElement (set, words [i]))
+	    insertElement (set, words [i]);
+
+    secs = now () - start;
+    printf ("serial     %13.1f %10d\n", secs * 1e9 / n, numElements (set));
+    destroySet (set);
+
+
+    /* Build it from the array with each number of threads. */
+
+    for (threads = 1; threads <= maxThreads; threads ++) {
+	start = now ();
+
+	if ((set = createSetFromArray (words, n, threads)) == NULL) {
+	    fprintf (stderr, "%s: failed to create set\n", argv [0]);
+	    exit (EXIT_FAILURE);
+	}
+
+	secs = now () - start;
+	printf ("%2d threads %13.1f %10d\n", threads, secs * 1e9 / n, numElements (set));
+	destroySet (set);
+    }
+
+    exit (EXIT_SUCCESS);
+}
@@ -0,0 +1,213 @@
+/*
+ * File:	concurrent_bench.c
+ *
+ * Description:	This file contains a multi-threaded benchmark for the lock-free set in
+ *		../concurrent_hash_table.
+ *
+ *		The program takes a file of words and an optional maximum number of
+ *		threads (by default 4). For every thread count from one up to the
+ *		maximum, a fresh set is built by the threads together, each inserting
+ *		a copy of every word in its share of the file. Then every thread looks
+ *		up all the words, and finally every thread deletes and re-inserts the
+ *		words in its share, which exercises the reclamation of replaced
+ *		strings. The throughput of each phase in millions of operations per
+ *		second is printed, along with the number of elements, which must be
+ *		the same for every thread count.
+ *
+ *		Usage: gcc -O2 -pthread concurrent_bench.c ../concurrent_hash_table/set.c
+ *		       ./a.out words.txt [threads]
+ *
+ */
+
+# include <stdio.h>
+# include <stdlib.h>
+# include <string.h>
+# include <time.h>
+# include <pthread.h>
+# include "../concurrent_hash_table/set.h"
+
+# define INSERT 0
+# define LOOKUP 1
+# define CHURN 2
+
+/* The work given to one thread */
+typedef struct job {
+    SET *set;
+    char **words;
+    int n;		/* The number of words in the file */
+    int lo, hi;		/* The share of the words this thread inserts and churns */
+    int phase;
+    long found;
+} JOB;
+
+
+/*
+ * Function:	now
+ *
+ * Description:	Returns the current time in seconds.
+ */
+
+static double now (void)
+{
+    struct timespec ts;
+
+    clock_gettime (CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+
+/*
+ * Function:	insertCopy
+ *
+ * Description:	Inserts a copy of `word` into `set`, freeing the copy if the set
+ *		did not take it.
+ */
+
+static void insertCopy (SET *set, char *word)
+{
+    char *copy;
+
+    if ((copy = strdup (word)) != NULL && !insertElement (set, copy))
+	free (copy);
+}
+
+
+/*
+ * Function:	work
+ *
+ * Description:	Runs one phase of the benchmark for a single thread.
+ */
+
+static void *work (void *arg)
+{
+    JOB *job = arg;
+    int i;
+
+    if (job->phase == INSERT)
+	for (i = job->lo; i < job->hi; i ++)
+	    insertCopy (job->set, job->words [i]);
+
+    else if (job->phase == LOOKUP)
+	for (i = 0; i < job->n; i ++)
+	    job->found += hasElement (job->set, job->words [(i + job->lo) % job->n]);
+
+    else
+	for (i = job->lo; i < job->hi; i ++)
+	    if (deleteElement (job->set, job->words [i]))
+		insertCopy (job->set, job->words [i]);
+
+    return NULL;
+}
+
+
+/*
+ * Function:	runPhase
+ *
+ * Description:	Runs `phase` on `threads` threads and returns the elapsed seconds.
+ */
+
+static double runPhase (JOB *jobs, pthread_t *tids, int threads, int phase)
+{
+    int t;
+    double start;
+
+    start = now ();
+
+    for (t = 0; t < threads; t ++) {
+	jobs [t].phase = phase;
+	if (pthread_create (&tids [t], NULL, work, &jobs [t]) != 0) {
+	    fprintf (stderr, "cannot create thread\n");
+	    exit (EXIT_FAILURE);
+	}
+    }
+
+    for (t = 0; t < threads; t ++)
+	pthread_join (tids [t], NULL);
+
+    return now () - start;
+}
+
+
+/*
+ * Function:	main
+ *
+ * Description:	Driver function for the benchmark.
+ */
+
+int main (int argc, char *argv [])
+{
+    FILE *fp;
+    char buffer [BUFSIZ];
+    char **words;
+    int n, max, t, threads, maxThreads;
+    double insert, lookup, churn;
+    JOB *jobs;
+    pthread_t *tids;
+    SET *set;
+
+    if (argc < 2 || argc > 3) {
+	fprintf (stderr, "usage: %s words [threads]\n", argv [0]);
+	exit (EXIT_FAILURE);
+    }
+
+    if ((fp = fopen (argv [1], "r")) == NULL) {
+	fprintf (stderr, "%s: cannot open %s\n", argv [0], argv [1]);
+	exit (EXIT_FAILURE);
+    }
+
+    n = 0;
+    max = 1024;
+    words = malloc (max * sizeof (char *));
+
+    while (words != NULL && fscanf (fp, "%s", buffer) == 1) {
+	if (n == max)
+	    words = realloc (words, (max *= 2) * sizeof (char *));
+	if (words != NULL && (words [n] = strdup (buffer)) != NULL)
+	    n ++;
+    }
+
+    fclose (fp);
+
+    maxThreads = argc == 3 ? atoi (argv [2]) : 4;
+
+    if (maxThreads < 1)
+	maxThreads = 1;
+
+    jobs = malloc (maxThreads * sizeof (JOB));
+    tids = malloc (maxThreads * sizeof (pthread_t));
+
+    if (words == NULL || jobs == NULL || tids == NULL || n == 0) {
+	fprintf (stderr, "%s: no words or out of memory\n", argv [0]);
+	exit (EXIT_FAILURE);
+    }
+
+    printf ("%d words\n", n);
+    printf ("threads   insert Mops/s   lookup Mops/s   churn Mops/s   elements\n");
+
+    for (threads = 1; threads <= maxThreads; threads ++) {
+	if ((set = createSet (n)) == NULL) {
+	    fprintf (stderr, "%s: failed to create set\n", argv [0]);
+	    exit (EXIT_FAILURE);
+	}
+
+	for (t = 0; t < threads; t ++) {
+	    jobs [t].set = set;
+	    jobs [t].words = words;
+	    jobs [t].n = n;
+	    jobs [t].lo = (long) n * t / threads;
+	    jobs [t].hi = (long) n * (t + 1) / threads;
+	    jobs [t].found = 0;
+	}
+
+	insert = runPhase (jobs, tids, threads, INSERT);
+	lookup = runPhase (jobs, tids, threads, LOOKUP);
+	churn = runPhase (jobs, tids, threads, CHURN);
+
+	printf ("%7d %15.2f %15.2f %14.2f %10d\n", threads, n / insert / 1e6,
+		(double) n * threads / lookup / 1e6, n / churn / 1e6, numElements (set));
+
+	destroySet (set);
+    }
+
+    exit (EXIT_SUCCESS);
+}
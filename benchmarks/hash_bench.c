@@ -0,0 +1,192 @@
+/*
+ * File:	hash_bench.c
+ *
+ * Description:	This file contains a benchmark comparing the string hash function in
+ *		../common/hash.h with the `31 * h + c` function the hash tables used
+ *		before it.
+ *
+ *		The program takes a file of words and an optional number of buckets
+ *		(by default the number of words). Each function hashes every word
+ *		repeatedly and its throughput is printed. Then the words are placed
+ *		into buckets both by the remainder of the hash and by masking it with
+ *		a power of two, and for each placement the fraction of empty buckets,
+ *		the longest bucket, and the number of colliding pairs relative to a
+ *		uniformly random hash (1.00 is ideal) are printed.
+ *
+ *		Usage: gcc -O2 hash_bench.c && ./a.out words.txt [buckets]
+ *
+ */
+
+# include <stdio.h>
+# include <stdlib.h>
+# include <string.h>
+# include <time.h>
+# include "../common/hash.h"
+
+# define ROUNDS 20 /* Number of times every word is hashed when timing */
+
+/*
+ * Function:	oldHash
+ *
+ * Description:	The hash function previously used by every hash table implementation.
+ */
+
+static unsigned long long oldHash (const char *s)
+{
+    unsigned hash = 0;
+
+    while (*s != '\0')
+	hash = (31 * hash + *s ++);
+
+    return hash;
+}
+
+
+/*
+ * Function:	now
+ *
+ * Description:	Returns the current time in seconds.
+ */
+
+static double now (void)
+{
+    struct timespec ts;
+
+    clock_gettime (CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+
+/*
+ * Function:	timeHash
+ *
+ * Description:	Prints the throughput of `hash` over the `n` words in `words`.
+ */
+
+static void timeHash (char *name, unsigned long long (*hash) (const char *),
+		      char **words, int n, size_t bytes)
+{
+    int i, r;
+    double start, secs;
+    volatile unsigned long long sink = 0;
+
+    start = now ();
+
+    for (r = 0; r < ROUNDS; r ++)
+	for (i = 0; i < n; i ++)
+	    sink += hash (words [i]);
+
+    secs = now () - start;
+    printf ("%-12s %8.2f ns/word %8.1f MB/s\n", name,
+	    secs * 1e9 / ((double) n * ROUNDS), bytes * (double) ROUNDS / secs / 1e6);
+}
+
+
+/*
+ * Function:	distribution
+ *
+ * Description:	Places the `n` words in `buckets` buckets, by remainder if `mask` is
+ *		zero and by masking with `buckets - 1` otherwise, and prints the
+ *		resulting distribution.
+ */
+
+static void distribution (char *name, unsigned long long (*hash) (const char *),
+			  char **words, int n, unsigned long buckets, int mask)
+{
+    int i;
+    unsigned long b, empty = 0, longest = 0;
+    double pairs = 0, expected;
+    unsigned *counts;
+
+    if ((counts = calloc (buckets, sizeof (unsigned))) == NULL) {
+	fprintf (stderr, "out of memory\n");
+	exit (EXIT_FAILURE);
+    }
+
+    for (i = 0; i < n; i ++) {
+	b = mask ? hash (words [i]) & (buckets - 1) : hash (words [i]) % buckets;
+	counts [b] ++;
+    }
+
+    for (b = 0; b < buckets; b ++) {
+	if (counts [b] == 0)
+	    empty ++;
+	if (counts [b] > longest)
+	    longest = counts [b];
+	pairs += (double) counts [b] * (counts [b] - 1) / 2;
+    }
+
+    expected = (double) n * (n - 1) / 2 / buckets;
+    printf ("%-12s %-6s %8lu buckets %6.2f%% empty %6lu longest %8.2f collisions\n",
+	    name, mask ? "mask" : "mod", buckets, 100.0 * empty / buckets,
+	    longest, expected > 0 ? pairs / expected : 0);
+
+    free (counts);
+}
+
+
+/*
+ * Function:	main
+ *
+ * Description:	Driver function for the benchmark.
+ */
+
+int main (int argc, char *argv [])
+{
+    FILE *fp;
+    char buffer [BUFSIZ];
+    char **words;
+    int n, max;
+    size_t bytes;
+    unsigned long buckets, pow2;
+
+    if (argc < 2 || argc > 3) {
+	fprintf (stderr, "usage: %s words [buckets]\n", argv [0]);
+	exit (EXIT_FAILURE);
+    }
+
+    if ((fp = fopen (argv [1], "r")) == NULL) {
+	fprintf (stderr, "%s: cannot open %s\n", argv [0], argv [1]);
+	exit (EXIT_FAILURE);
+    }
+
+    n = 0;
+    max = 1024;
+    bytes = 0;
+    words = malloc (max * sizeof (char *));
+
+    while (words != NULL && fscanf (fp, "%s", buffer) == 1) {
+	if (n == max)
+	    words = realloc (words, (max *= 2) * sizeof (char *));
+	if (words != NULL && (words [n] = strdup (buffer)) != NULL)
+	    bytes += strlen (words [n ++]);
+    }
+
+    fclose (fp);
+
+    if (words == NULL) {
+	fprintf (stderr, "%s: out of memory\n", argv [0]);
+	exit (EXIT_FAILURE);
+    }
+
+    buckets = argc == 3 ? strtoul (argv [2], NULL, 10) : (unsigned long) n;
+
+    if (buckets == 0)
+	buckets = 1;
+
+    for (pow2 = 1; pow2 < buckets; pow2 *= 2)
+	;
+
+    printf ("%d words, %.2f bytes per word\n\n", n, n ? (double) bytes / n : 0);
+
+    timeHash ("31*h+c", oldHash, words, n, bytes);
+    timeHash ("hashString", hashString, words, n, bytes);
+    printf ("\n");
+
+    distribution ("31*h+c", oldHash, words, n, buckets, 0);
+    distribution ("31*h+c", oldHash, words, n, pow2, 1);
+    distribution ("hashString", hashString, words, n, buckets, 0);
+    distribution ("hashString", hashString, words, n, pow2, 1);
+
+    exit (EXIT_SUCCESS);
+}
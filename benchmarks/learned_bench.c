@@ -0,0 +1,194 @@
+/*
+ * File:	learned_bench.c
+ *
+ * Description:	This file contains a benchmark comparing the ways a sorted_array set
+ *		can be searched: the binary search of a set that is changed, the
+ *		Eytzinger layout of a frozen set, and learned indexes with a range of
+ *		error bounds.
+ *
+ *		The program takes a file of words. The set is built from all of them
+ *		and the unique words are shuffled. For each kind of search every unique
+ *		word is looked up (hits), and so is every word with a character appended
+ *		(mostly misses), and the time per lookup and per build are printed.
+ *
+ *		Usage: gcc -O2 -pthread learned_bench.c ../sorted_array/set.c
+ *		       ./a.out words.txt
+ *
+ */
+
+# include <stdio.h>
+# include <stdlib.h>
+# include <string.h>
+# include <time.h>
+# include "../sorted_array/set.h"
+
+# define ROUNDS 5 /* Number of times every word is looked up when timing */
+
+/* The error bounds of the learned indexes compared */
+
+static int errors [] = {8, 32, 128, 512};
+
+
+/*
+ * Function:	now
+ *
+ * Description:	Returns the time in seconds from an arbitrary start.
+ */
+
+static double now (void)
+{
+    struct timespec ts;
+
+    clock_gettime (CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+
+/*
+ * Function:	readWords
+ *
+ * Description:	Returns an array of copies of the words in the file `fp`, and sets
+ *		`n` to their number.
+ */
+
+static char **readWords (FILE *fp, int *n)
+{
+    char buffer [BUFSIZ];
+    char **words;
+    int max;
+
+    *n = 0;
+    max = 1024;
+    words = malloc (max * sizeof (char *));
+
+    while (words != NULL && fscanf (fp, "%s", buffer) == 1) {
+	if (*n == max)
+	    words = realloc (words, (max *= 2) * sizeof (char *));
+	if (words != NULL && (words [*n] = strdup (buffer)) != NULL)
+	    (*n) ++;
+    }
+
+    return words;
+}
+
+
+/*
+ * Function:	timeLookups
+ *
+ * Description:	Looks up each of the `n` words in `queries` in `set` ROUNDS times,
+ *		and returns the time per lookup in nanoseconds. The number of words
+ *		found is added to `found`.
+ */
+
+static double timeLookups (SET *set, char **queries, int n, long *found)
+{
+    double start;
+    int i, round;
+
+    start = now ();
+
+    for (round = 0; round < ROUNDS; round ++)
+	for (i = 0; i < n; i ++)
+	    *found += hasElement (set, queries [i]);
+
+    return (now () - start) / ((double) ROUNDS * n) * 1e9;
+}
+
+
+/*
+ * Function:	main
+ *
+ * Description:	Driver function for the benchmark.
+ */
+
+int main (int argc, char *argv [])
+{
+    SET *set;
+    FILE *fp;
+    char **words, **queries [2], *tmp;
+    int i, j, k, n, unique;
+    long found [2];
+    double start, build, hits, misses;
+    size_t length;
+
+    if (argc != 2) {
+	fprintf (stderr, "usage: %s words.txt\n", argv [0]);
+	exit (EXIT_FAILURE);
+    }
+
+    if ((fp = fopen (argv [1], "r")) == NULL) {
+	fprintf (stderr, "%s: cannot open %s\n", argv [0], argv [1]);
+	exit (EXIT_FAILURE);
+    }
+
+    words = readWords (fp, &n);
+    fclose (fp);
+
+    if (words == NULL || (set = createSetFromArray (words, n, 1)) == NULL ||
+	(queries [0] = sortElements (set)) == NULL) {
+	fprintf (stderr, "%s: out of memory\n", argv [0]);
+	exit (EXIT_FAILURE);
+    }
+
+    unique = numElements (set);
+
+
+    /* Shuffle the unique words, and make a copy of each with a character appended. */
+
+    if ((queries [1] = malloc (unique * sizeof (char *))) == NULL) {
+	fprintf (stderr, "%s: out of memory\n", argv [0]);
+	exit (EXIT_FAILURE);
+    }
+
+    srand (1);
+
+    for (i = unique - 1; i > 0; i --) {
+	j = rand () % (i + 1);
+	tmp = queries [0] [i];
+	queries [0] [i] = queries [0] [j];
+	queries [0] [j] = tmp;
+    }
+
+    for (i = 0; i < unique; i ++) {
+	length = strlen (queries [0] [i]);
+	queries [1] [i] = malloc (length + 2);
+	memcpy (queries [1] [i], queries [0] [i], length);
+	strcpy (queries [1] [i] + length, "x");
+    }
+
+
+    /* Time each kind of search, from plain binary search to the learned indexes. */
+
+    printf ("%d words, %d unique\n", n, unique);
+
+    for (k = -2; k < (int) (sizeof (errors) / sizeof (errors [0])); k ++) {
+	start = now ();
+
+	if (k == -2)
+	    thawSet (set);
+	else if (k == -1)
+	    freezeSet (set);
+	else
+	    learnSet (set, errors [k]);
+
+	build = (now () - start) * 1e3;
+	found [0] = found [1] = 0;
+	hits = timeLookups (set, queries [0], unique, &found [0]);
+	misses = timeLookups (set, queries [1], unique, &found [1]);
+
+	if (found [0] != (long) ROUNDS * unique)
+	    fprintf (stderr, "%s: a word was not found\n", argv [0]);
+
+	if (k == -2)
+	    printf ("binary search     ");
+	else if (k == -1)
+	    printf ("eytzinger         ");
+	else
+	    printf ("learned, error %-3d", errors [k]);
+
+	printf ("  build %7.2f ms  hits %6.1f ns  misses %6.1f ns\n", build, hits, misses);
+    }
+
+    destroySet (set);
+    exit (EXIT_SUCCESS);
+}
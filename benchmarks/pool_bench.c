@@ -0,0 +1,183 @@
+/*
+ * File:	pool_bench.c
+ *
+ * Description:	This file contains a benchmark of the node pools in ../common/pool.h,
+ *		for the set implementations built on a list of nodes. It is built
+ *		once as it is and once with POOL_MALLOC defined, which makes the
+ *		lists allocate and free each node with malloc, and the two runs are
+ *		compared.
+ *
+ *		The program takes a file of words and an optional size to create the
+ *		set with (by default the number of words). Its unique words are
+ *		inserted in random order, then a random half of them are deleted and
+ *		inserted again, and finally the set is destroyed. The time per word
+ *		of the insertions and of the deletions and reinsertions is printed,
+ *		along with the time taken to destroy the set.
+ *
+ *		Usage: gcc -O2 -pthread -I../binary_search_tree pool_bench.c \
+ *		           ../binary_search_tree/set.c ../binary_search_tree/list.c
+ *		       gcc -O2 -pthread -DPOOL_MALLOC -I../binary_search_tree \
+ *		           pool_bench.c ../binary_search_tree/set.c ../binary_search_tree/list.c
+ *		       ./a.out words.txt [size]
+ *
+ *		The same works for hashing_with_chaining and
+ *		hashing_with_sorted_list_chaining.
+ *
+ */
+
+# include <stdio.h>
+# include <stdlib.h>
+# include <string.h>
+# include <time.h>
+# include "set.h"
+
+
+/*
+ * Function:	now
+ *
+ * Description:	Returns the time in seconds from an arbitrary start.
+ */
+
+static double now (void)
+{
+    struct timespec ts;
+
+    clock_gettime (CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+
+/*
+ * Function:	compareStrings
+ *
+ * Description:	Compares the strings pointed to by `a` and `b`, for use with qsort.
+ */
+
+static int compareStrings (const void *a, const void *b)
+{
+    return strcmp (*(char **) a, *(char **) b);
+}
+
+
+/*
+ * Function:	readWords
+ *
+ * Description:	Returns an array of copies of the words in the file `fp`, and sets
+ *		`n` to their number.
+ */
+
+static char **readWords (FILE *fp, int *n)
+{
+    char buffer [BUFSIZ];
+    char **words;
+    int max;
+
+    *n = 0;
+    max = 1024;
+    words = malloc (max * sizeof (char *));
+
+    while (words != NULL && fscanf (fp, "%s", buffer) == 1) {
+	if (*n == max)
+	    words = realloc (words, (max *= 2) * sizeof (char *));
+	if (words != NULL && (words [*n] = strdup (buffer)) != NULL)
+	    (*n) ++;
+    }
+
+    return words;
+}
+
+
+/*
+ * Function:	main
+ *
+ * Description:	Driver function for the benchmark.
+ */
+
+int main (int argc, char *argv [])
+{
+    SET *set;
+    FILE *fp;
+    char **words, *tmp;
+    int i, j, n, unique, size;
+    double start, insert, churn, destroy;
+
+    if (argc < 2 || argc > 3) {
+	fprintf (stderr, "usage: %s words.txt [size]\n", argv [0]);
+	exit (EXIT_FAILURE);
+    }
+
+    if ((fp = fopen (argv [1], "r")) == NULL) {
+	fprintf (stderr, "%s: cannot open %s\n", argv [0], argv [1]);
+	exit (EXIT_FAILURE);
+    }
+
+    words = readWords (fp, &n);
+    fclose (fp);
+
+    if (words == NULL) {
+	fprintf (stderr, "%s: out of memory\n", argv [0]);
+	exit (EXIT_FAILURE);
+    }
+
+    size = argc == 3 ? atoi (argv [2]) : n;
+
+
+    /* Drop the duplicate words and shuffle the rest. */
+
+    qsort (words, n, sizeof (char *), compareStrings);
+
+    for (i = 0, unique = 0; i < n; i ++)
+	if (unique == 0 || strcmp (words [i], words [unique - 1]) != 0)
+	    words [unique ++] = words [i];
+
+    srand (1);
+
+    for (i = unique - 1; i > 0; i --) {
+	j = rand () % (i + 1);
+	tmp = words [i];
+	words [i] = words [j];
+	words [j] = tmp;
+    }
+
+
+    /* Insert every word, delete and reinsert half of them, and destroy the set. */
+
+    if ((set = createSet (size)) == NULL) {
+	fprintf (stderr, "%s: failed to create set\n", argv [0]);
+	exit (EXIT_FAILURE);
+    }
+
+    start = now ();
+
+    for (i = 0; i < unique; i ++)
+	insertElement (set, words [i]);
+
+    insert = (now () - start) / unique * 1e9;
+    start = now ();
+
+    for (i = 0; i < unique / 2; i ++)
+	deleteElement (set, words [i * 2]);
+
+    for (i = 0; i < unique / 2; i ++)
+	insertElement (set, words [i * 2]);
+
+    churn = (now () - start) / (unique / 2 * 2) * 1e9;
+
+    if (numElements (set) != unique)
+	fprintf (stderr, "%s: wrong number of elements\n", argv [0]);
+
+    start = now ();
+    destroySet (set);
+    destroy = (now () - start) * 1e3;
+
+# ifdef POOL_MALLOC
+    printf ("malloc: ");
+# else
+    printf ("pool:   ");
+# endif
+
+    printf ("%d words  insert %7.1f ns  delete/reinsert %7.1f ns  destroy %7.2f ms\n",
+	    unique, insert, churn, destroy);
+
+    exit (EXIT_SUCCESS);
+}
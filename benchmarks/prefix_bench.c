@@ -0,0 +1,196 @@
+/*
+ * File:	prefix_bench.c
+ *
+ * Description:	This file contains a benchmark comparing lookups in the sorted_array
+ *		set, whose search runs on the eight byte prefixes of its elements,
+ *		with the plain binary search over the strings that it used before.
+ *
+ *		The program takes a file of words. The set is built from all of them
+ *		and the unique words are shuffled. Every unique word is then looked up
+ *		(hits), and so is every word with a character appended (mostly misses,
+ *		which share the first eight bytes with a hit more often), first with
+ *		the old binary search over the sorted array of strings and then with
+ *		hasElement. The time per lookup is printed for each.
+ *
+ *		Usage: gcc -O2 -pthread prefix_bench.c ../sorted_array/set.c
+ *		       ./a.out words.txt
+ *
+ */
+
+# include <stdio.h>
+# include <stdlib.h>
+# include <string.h>
+# include <time.h>
+# include "../sorted_array/set.h"
+
+# define ROUNDS 5 /* Number of times every word is looked up when timing */
+
+/*
+ * Function:	oldSearch
+ *
+ * Description:	The binary search sorted_array used before keeping prefixes: returns
+ *		whether `elt` is among the `n` sorted strings in `elts`.
+ */
+
+static int oldSearch (char **elts, int n, char *elt)
+{
+    int low, mid, high, diff;
+
+    low = 0;
+    high = n - 1;
+
+    while (low <= high) {
+	mid = (low + high) / 2;
+	diff = strcmp (elt, elts [mid]);
+
+	if (diff < 0)
+	    high = mid - 1;
+	else if (diff > 0)
+	    low = mid + 1;
+	else
+	    return 1;
+    }
+
+    return 0;
+}
+
+
+/*
+ * Function:	now
+ *
+ * Description:	Returns the time in seconds from an arbitrary start.
+ */
+
+static double now (void)
+{
+    struct timespec ts;
+
+    clock_gettime (CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+
+/*
+ * Function:	readWords
+ *
+ * Description:	Returns an array of copies of the words in the file `fp`, and sets
+ *		`n` to their number.
+ */
+
+static char **readWords (FILE *fp, int *n)
+{
+    char buffer [BUFSIZ];
+    char **words;
+    int max;
+
+    *n = 0;
+    max = 1024;
+    words = malloc (max * sizeof (char *));
+
+    while (words != NULL && fscanf (fp, "%s", buffer) == 1) {
+	if (*n == max)
+	    words = realloc (words, (max *= 2) * sizeof (char *));
+	if (words != NULL && (words [*n] = strdup (buffer)) != NULL)
+	    (*n) ++;
+    }
+
+    return words;
+}
+
+
+/*
+ * Function:	main
+ *
+ * Description:	Driver function for the benchmark.
+ */
+
+int main (int argc, char *argv [])
+{
+    SET *set;
+    FILE *fp;
+    char **words, **sorted, **queries [2], *tmp;
+    int i, j, n, unique, round, found;
+    double start, old, new;
+    size_t length;
+
+    if (argc != 2) {
+	fprintf (stderr, "usage: %s words.txt\n", argv [0]);
+	exit (EXIT_FAILURE);
+    }
+
+    if ((fp = fopen (argv [1], "r")) == NULL) {
+	fprintf (stderr, "%s: cannot open %s\n", argv [0], argv [1]);
+	exit (EXIT_FAILURE);
+    }
+
+    words = readWords (fp, &n);
+    fclose (fp);
+
+    if (words == NULL || (set = createSetFromArray (words, n, 1)) == NULL ||
+	(sorted = sortElements (set)) == NULL) {
+	fprintf (stderr, "%s: out of memory\n", argv [0]);
+	exit (EXIT_FAILURE);
+    }
+
+    unique = numElements (set);
+
+
+    /* Shuffle the unique words, and make a copy of each with a character appended. */
+
+    queries [0] = malloc (unique * sizeof (char *));
+    queries [1] = malloc (unique * sizeof (char *));
+
+    if (queries [0] == NULL || queries [1] == NULL) {
+	fprintf (stderr, "%s: out of memory\n", argv [0]);
+	exit (EXIT_FAILURE);
+    }
+
+    memcpy (queries [0], sorted, unique * sizeof (char *));
+    srand (1);
+
+    for (i = unique - 1; i > 0; i --) {
+	j = rand () % (i + 1);
+	tmp = queries [0] [i];
+	queries [0] [i] = queries [0] [j];
+	queries [0] [j] = tmp;
+    }
+
+    for (i = 0; i < unique; i ++) {
+	length = strlen (queries [0] [i]);
+	queries [1] [i] = malloc (length + 2);
+	memcpy (queries [1] [i], queries [0] [i], length);
+	strcpy (queries [1] [i] + length, "x");
+    }
+
+
+    /* Time both searches on the hits and the misses. */
+
+    printf ("%d words, %d unique\n", n, unique);
+
+    for (j = 0; j < 2; j ++) {
+	found = 0;
+	start = now ();
+
+	for (round = 0; round < ROUNDS; round ++)
+	    for (i = 0; i < unique; i ++)
+		found += oldSearch (sorted, unique, queries [j] [i]);
+
+	old = (now () - start) / ((double) ROUNDS * unique) * 1e9;
+
+	start = now ();
+
+	for (round = 0; round < ROUNDS; round ++)
+	    for (i = 0; i < unique; i ++)
+		found -= hasElement (set, queries [j] [i]);
+
+	new = (now () - start) / ((double) ROUNDS * unique) * 1e9;
+
+	if (found != 0)
+	    fprintf (stderr, "%s: the searches disagree\n", argv [0]);
+
+	printf ("%s:  strcmp %6.1f ns  prefixes %6.1f ns\n",
+		j == 0 ? "hits  " : "misses", old, new);
+    }
+
+    exit (EXIT_SUCCESS);
+}
@@ -0,0 +1,182 @@
+/*
+ * File:	set_bench.c
+ *
+ * Description:	This file contains a benchmark that can be built against any of the
+ *		set implementations, to compare them on the same corpus.
+ *
+ *		The program takes a file of words and an optional size to create the
+ *		set with (by default the number of words, which fixed-size sets need).
+ *		All words are read into memory first, then a set is built from them
+ *		the way each main.c does, and the build time per word is printed.
+ *		Next every word is looked up (hits) and so is every word with a
+ *		character appended (mostly misses), and the time per lookup is
+ *		printed. Finally the heap memory taken by the set, including the
+ *		copies of its strings, is printed.
+ *
+ *		Most sets store the caller's strings, so each word is copied with
+ *		strdup before being inserted. For a set that stores its own copies,
+ *		define SET_COPIES_KEYS and the words are inserted directly. To
+ *		freeze a set that supports it (sorted_array) after building it,
+ *		define SET_FREEZE. Heap memory is only measured with the GNU C
+ *		library.
+ *
+ *		Usage: gcc -O2 -I../hash_table set_bench.c ../hash_table/set.c
+ *		       gcc -O2 -DSET_COPIES_KEYS -I../inline_hash_table set_bench.c \
+ *		           ../inline_hash_table/set.c
+ *		       ./a.out words.txt [size]
+ *
+ *		For an implementation built on a list, compile its list.c as well.
+ *
+ */
+
+# include <stdio.h>
+# include <stdlib.h>
+# include <string.h>
+# include <time.h>
+# ifdef __GLIBC__
+# include <malloc.h>
+# endif
+# include "set.h"
+
+
+/*
+ * Function:	now
+ *
+ * Description:	Returns the current time in seconds.
+ */
+
+static double now (void)
+{
+    struct timespec ts;
+
+    clock_gettime (CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+
+/*
+ * Function:	heapInUse
+ *
+ * Description:	Returns the number of bytes allocated on the heap, or 0 if unknown.
+ */
+
+static size_t heapInUse (void)
+{
+# if defined (__GLIBC__) && (__GLIBC__ > 2 || __GLIBC_MINOR__ >= 33)
+    struct mallinfo2 mi = mallinfo2 ();
+
+    return mi.uordblks + mi.hblkhd;
+# else
+    return 0;
+# endif
+}
+
+
+/*
+ * Function:	main
+ *
+ * Description:	Driver function for the benchmark.
+ */
+
+int main (int argc, char *argv [])
+{
+    FILE *fp;
+    char buffer [BUFSIZ];
+    char **words, **misses;
+    int i, n, max, size, found;
+    size_t before, after;
+    double start, build, hit, miss;
+    SET *set;
+
+    if (argc < 2 || argc > 3) {
+	fprintf (stderr, "usage: %s words [size]\n", argv [0]);
+	exit (EXIT_FAILURE);
+    }
+
+    if ((fp = fopen (argv [1], "r")) == NULL) {
+	fprintf (stderr, "%s: cannot open %s\n", argv [0], argv [1]);
+	exit (EXIT_FAILURE);
+    }
+
+    n = 0;
+    max = 1024;
+    words = malloc (max * sizeof (char *));
+
+    while (words != NULL && fscanf (fp, "%s", buffer) == 1) {
+	if (n == max)
+	    words = realloc (words, (max *= 2) * sizeof (char *));
+	if (words != NULL && (words [n] = strdup (buffer)) != NULL)
+	    n ++;
+    }
+
+    fclose (fp);
+
+    if (words == NULL || (misses = malloc ((n + 1) * sizeof (char *))) == NULL) {
+	fprintf (stderr, "%s: out of memory\n", argv [0]);
+	exit (EXIT_FAILURE);
+    }
+
+    for (i = 0; i < n; i ++) {
+	snprintf (buffer, sizeof (buffer), "%s#", words [i]);
+	if ((misses [i] = strdup (buffer)) == NULL) {
+	    fprintf (stderr, "%s: out of memory\n", argv [0]);
+	    exit (EXIT_FAILURE);
+	}
+    }
+
+
+    /* Build the set. */
+
+    size = argc == 3 ? atoi (argv [2]) : n;
+    before = heapInUse ();
+    start = now ();
+
+    if ((set = createSet (size)) == NULL) {
+	fprintf (stderr, "%s: failed to create set\n", argv [0]);
+	exit (EXIT_FAILURE);
+    }
+
+    for (i = 0; i < n; i ++)
+	if (!hasElement (set, words [i]))
+# ifdef SET_COPIES_KEYS
+	    insertElement (set, words [i]);
+# else
+	    insertElement (set, strdup (words [i]));
+# endif
+
+# ifdef SET_FREEZE
+    freezeSet (set);
+# endif
+
+    build = now () - start;
+    after = heapInUse ();
+
+
+    /* Look up every word, then every word with a character appended. */
+
+    found = 0;
+    start = now ();
+
+    for (i = 0; i < n; i ++)
+	found += hasElement (set, words [i]);
+
+    hit = now () - start;
+    start = now ();
+
+    for (i = 0; i < n; i ++)
+	found += hasElement (set, misses [i]);
+
+    miss = now () - start;
+
+    printf ("%d words, %d unique, %d found\n", n, numElements (set), found);
+    printf ("build %10.1f ns/word\n", build * 1e9 / n);
+    printf ("hit   %10.1f ns/lookup\n", hit * 1e9 / n);
+    printf ("miss  %10.1f ns/lookup\n", miss * 1e9 / n);
+
+    if (after > before)
+	printf ("heap  %10zu bytes, %.1f per element\n", after - before,
+		(double) (after - before) / numElements (set));
+
+    destroySet (set);
+    exit (EXIT_SUCCESS);
+}
@@ -0,0 +1,259 @@
+/*
+ * File:	tree_bench.c
+ *
+ * Description:	This file contains a benchmark of a list implementation on input in
+ *		sorted order and in random order. Sorted or nearly sorted input is the
+ *		worst case of a search tree that is not kept balanced.
+ *
+ *		The program takes a file of words. Its unique words are inserted into
+ *		a list in sorted order, then each is looked up in random order, then
+ *		all are deleted in sorted order, and the time per word of each pass is
+ *		printed. The same is then done with the words inserted and deleted in
+ *		random order.
+ *
+ *		Finally every word is given a long common prefix, so that comparing
+ *		them takes whole strings, and inserted in random order. Every other
+ *		word is deleted and freed, the rest are looked up, and then they are
+ *		deleted and freed too. A list must not use an item once it has been
+ *		deleted, which a build with -fsanitize=address checks.
+ *
+ *		Usage: gcc -O2 -I../binary_search_tree tree_bench.c ../binary_search_tree/list.c
+ *		       ./a.out words.txt
+ *
+ */
+
+# include <stdio.h>
+# include <stdlib.h>
+# include <string.h>
+# include <time.h>
+# include "list.h"
+
+
+/*
+ * Function:	now
+ *
+ * Description:	Returns the time in seconds from an arbitrary start.
+ */
+
+static double now (void)
+{
+    struct timespec ts;
+
+    clock_gettime (CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+
+/*
+ * Function:	compareStrings
+ *
+ * Description:	Compares the strings pointed to by `a` and `b`, for use with qsort.
+ */
+
+static int compareStrings (const void *a, const void *b)
+{
+    return strcmp (*(char **) a, *(char **) b);
+}
+
+
+/*
+ * Function:	readWords
+ *
+ * Description:	Returns an array of copies of the words in the file `fp`, and sets
+ *		`n` to their number.
+ */
+
+static char **readWords (FILE *fp, int *n)
+{
+    char buffer [BUFSIZ];
+    char **words;
+    int max;
+
+    *n = 0;
+    max = 1024;
+    words = malloc (max * sizeof (char *));
+
+    while (words != NULL && fscanf (fp, "%s", buffer) == 1) {
+	if (*n == max)
+	    words = realloc (words, (max *= 2) * sizeof (char *));
+	if (words != NULL && (words [*n] = strdup (buffer)) != NULL)
+	    (*n) ++;
+    }
+
+    return words;
+}
+
+
+/*
+ * Function:	shuffle
+ *
+ * Description:	Puts the `n` strings in `words` in random order.
+ */
+
+static void shuffle (char **words, int n)
+{
+    char *tmp;
+    int i, j;
+
+    for (i = n - 1; i > 0; i --) {
+	j = rand () % (i + 1);
+	tmp = words [i];
+	words [i] = words [j];
+	words [j] = tmp;
+    }
+}
+
+
+/*
+ * Function:	runPasses
+ *
+ * Description:	Inserts the `n` words in `order` into a new list, looks up each of
+ *		the words in `lookups`, deletes the words in `order`, and prints the
+ *		time per word of each pass under the name `label`.
+ */
+
+static void runPasses (char *label, char **order, char **lookups, int n)
+{
+    LIST *list;
+    double start, insert, lookup, delete;
+    int i, found = 0;
+
+    if ((list = createList ()) == NULL) {
+	fprintf (stderr, "failed to create list\n");
+	exit (EXIT_FAILURE);
+    }
+
+    start = now ();
+
+    for (i = 0; i < n; i ++)
+	insertItem (list, order [i]);
+
+    insert = (now () - start) / n * 1e9;
+    start = now ();
+
+    for (i = 0; i < n; i ++)
+	found += hasItem (list, lookups [i]);
+
+    lookup = (now () - start) / n * 1e9;
+    start = now ();
+
+    for (i = 0; i < n; i ++)
+	deleteItem (list, order [i]);
+
+    delete = (now () - start) / n * 1e9;
+
+    if (found != n || numItems (list) != 0)
+	fprintf (stderr, "%s: wrong result\n", label);
+
+    printf ("%-7s insert %7.1f ns  lookup %7.1f ns  delete %7.1f ns\n",
+	    label, insert, lookup, delete);
+
+    destroyList (list);
+}
+
+
+/*
+ * Function:	checkDeletes
+ *
+ * Description:	Inserts the `n` words in `order`, each with a long prefix added,
+ *		into a new list, deletes and frees every other one, checks that the
+ *		rest are still present, and deletes and frees them too.
+ */
+
+static void checkDeletes (char **order, int n)
+{
+    static char prefix [] = "https://www.example.com/documents/archive/";
+    LIST *list;
+    char **keys;
+    int i, found = 0;
+
+    if ((list = createList ()) == NULL ||
+	(keys = malloc ((n + 1) * sizeof (char *))) == NULL) {
+	fprintf (stderr, "failed to create list\n");
+	exit (EXIT_FAILURE);
+    }
+
+    for (i = 0; i < n; i ++) {
+	if ((keys [i] = malloc (sizeof (prefix) + strlen (order [i]))) == NULL) {
+	    fprintf (stderr, "out of memory\n");
+	    exit (EXIT_FAILURE);
+	}
+
+	strcat (strcpy (keys [i], prefix), order [i]);
+	insertItem (list, keys [i]);
+    }
+
+    for (i = 0; i < n; i += 2) {
+	deleteItem (list, keys [i]);
+	free (keys [i]);
+    }
+
+    for (i = 1; i < n; i += 2)
+	found += hasItem (list, keys [i]);
+
+    for (i = 1; i < n; i += 2) {
+	deleteItem (list, keys [i]);
+	free (keys [i]);
+    }
+
+    if (found != n / 2 || numItems (list) != 0)
+	fprintf (stderr, "delete: wrong result\n");
+    else
+	printf ("delete and free passed\n");
+
+    destroyList (list);
+    free (keys);
+}
+
+
+/*
+ * Function:	main
+ *
+ * Description:	Driver function for the benchmark.
+ */
+
+int main (int argc, char *argv [])
+{
+    FILE *fp;
+    char **words, **sorted, **random;
+    int i, n, unique;
+
+    if (argc != 2) {
+	fprintf (stderr, "usage: %s words.txt\n", argv [0]);
+	exit (EXIT_FAILURE);
+    }
+
+    if ((fp = fopen (argv [1], "r")) == NULL) {
+	fprintf (stderr, "%s: cannot open %s\n", argv [0], argv [1]);
+	exit (EXIT_FAILURE);
+    }
+
+    words = readWords (fp, &n);
+    fclose (fp);
+
+    if (words == NULL || (sorted = malloc ((n + 1) * sizeof (char *))) == NULL ||
+	(random = malloc ((n + 1) * sizeof (char *))) == NULL) {
+	fprintf (stderr, "%s: out of memory\n", argv [0]);
+	exit (EXIT_FAILURE);
+    }
+
+
+    /* Sort the words, drop the duplicates, and make a shuffled copy. */
+
+    memcpy (sorted, words, n * sizeof (char *));
+    qsort (sorted, n, sizeof (char *), compareStrings);
+
+    for (i = 0, unique = 0; i < n; i ++)
+	if (unique == 0 || strcmp (sorted [i], sorted [unique - 1]) != 0)
+	    sorted [unique ++] = sorted [i];
+
+    memcpy (random, sorted, unique * sizeof (char *));
+    srand (1);
+    shuffle (random, unique);
+
+    printf ("%d words, %d unique\n", n, unique);
+    runPasses ("sorted", sorted, random, unique);
+    runPasses ("random", random, random, unique);
+    checkDeletes (random, unique);
+    exit (EXIT_SUCCESS);
+}
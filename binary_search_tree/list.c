@@ -6,8 +6,22 @@
 *
 *  Description:	This file contains the public and private function definitions for a list abstract
 *               data type in the form of a Binary Search Tree.  Items are stored in sorted order
-*               in a BST, and duplicates are allowed.  Location, insertion and deletion are all
-*               logarithmic time.
+*               in a BST, and duplicates are allowed.  The tree is kept balanced as an AVL tree:
+*               the heights of the two subtrees of every node differ by at most one, and an
+*               insertion or deletion that breaks this is repaired with rotations on the way
+*               back up.  Location, insertion and deletion are all logarithmic time, whatever
+*               the order of the input.
+*
+*               Each node also records the number of nodes in its subtree, which is kept up to
+*               date along with its height.  This finds the rank of an item, the number of items
+*               less than it, and the item of a given rank, in logarithmic time too.
+*
+*               Every traversal is iterative.  An insertion or deletion records the links it
+*               follows on a stack, which the height bound of an AVL tree keeps short.
+*
+*               Nodes come from a pool of slabs owned by the list (see ../common/pool.h), so
+*               they are packed together, deleted nodes are reused, and destroying the list
+*               frees whole slabs.
 *
 */
 
@@ -15,6 +29,9 @@
 #include <stdlib.h>
 #include <string.h>
 #include "list.h"
+#include "../common/pool.h"
+
+#define MAX_HEIGHT 64		//No AVL tree of fewer than 2^31 nodes is higher
 
 /* Datatype declarations: */
 
@@ -26,6 +43,10 @@ typedef struct node {
 
   struct node *right;
 
+  int height;			//Height of the subtree rooted here, a leaf being 1
+
+  int size;			//Number of nodes in the subtree rooted here
+
 } NODE;
 
 struct list {
@@ -33,17 +54,23 @@ struct list {
   int count;
 
   NODE *root;
+
+  POOL pool;			//The nodes
 };
 
 /* Private function prototypes: */
 
-static int hasNode (NODE *node, char *item);
+static int height (NODE *node);
+
+static int size (NODE *node);
+
+static void updateNode (NODE *node);
 
-static NODE *insertNode (NODE *root, NODE *new);
+static void rotateLeft (NODE **link);
 
-static NODE *deleteNode (NODE *root, char *data, int *success);
+static void rotateRight (NODE **link);
 
-static void destroyNode (NODE *node);
+static void rebalance (NODE ***path, int depth);
 
 
 /*
@@ -67,157 +94,246 @@ LIST *createList (void) {
 
   list->root = NULL;
 
+  initPool (&list->pool, sizeof(NODE));
+
   return list;
 }
 
 
 /*
- *Function:	destroyNode
+ *Function:	destroyList
  *
- *Description:	Deletes all nodes in the BST, deallocating memory in the process. Recursion
- *		used in postorder sequence.
+ *Description:	Deallocates memory associated with "list".  The nodes are freed a slab at a
+ *		time by releasing the pool.  The items themselves belong to the caller.
+ *
+ *Complexity:	O(n/POOL_LIMIT)
  *
- *Complexity:	Average: O(logn)
- *		Worst:   O(n)
  */
 
-static void destroyNode (NODE *node) {
+void destroyList (LIST *list) {
 
-  if (node != NULL) {	//Non-empty tree
+  releasePool (&list->pool);
 
-    destroyNode (node->left);
+  free (list);
+}
 
-    destroyNode (node->right);
 
-    free (node);
-  }
+/*
+ *Function:	numItems
+ *
+ *Description:	Returns the number of items in "list"
+ *
+ *Complexity:	O(1)
+ *
+ */
+
+int numItems (LIST *list) {
 
-  return;
+  return list->count;
 }
 
 
 /*
- *Function:	destroyList
+ *Function:	hasItem
+ *
+ *Description:	Returns one if "item" is present in "list," and zero otherwise
  *
- *Description:	Deallocates memory associated with "list"
+ *Complexity:	O(logn)
  *
- *Complexity:	Average: O(logn)
- *		Worst:   O(n)
  */
 
-void destroyList (LIST *list) {
+int hasItem (LIST *list, char *item) {
 
-  destroyNode (list->root);
+  NODE *node;
 
-  free (list);
+  int diff;
+
+  node = list->root;
+
+  while (node) {
+
+    diff = strcmp (item, node->data);
+
+    if (diff == 0)
+
+      return 1;
+
+    node = diff < 0 ? node->left : node->right;
+  }
+
+  return 0;
 }
 
 
 /*
- *Function:	numItems
+ *Function:	height
  *
- *Description:	Returns the number of items in "list"
+ *Description:	Returns the height of the subtree rooted at "node", zero if it is empty
  *
  *Complexity:	O(1)
  *
  */
 
-int numItems (LIST *list) {
+static int height (NODE *node) {
 
-  return list->count;
+  return node ? node->height : 0;
 }
 
 
 /*
- *Function:	hasNode
+ *Function:	size
  *
- *Description:	Traverses BST until input node is found, returns one if found and zero otherwise
+ *Description:	Returns the number of nodes in the subtree rooted at "node", zero if it is empty
+ *
+ *Complexity:	O(1)
  *
- *Complexity:	Average: O(logn)
- *		Worst:   O(n)
  */
 
-static int hasNode (NODE *node, char *item) {
+static int size (NODE *node) {
 
-  if (!node)					//Base case 1
+  return node ? node->size : 0;
+}
 
-    return 0;
 
-  if (strcmp (node->data, item) == 0)		//Base case 2
+/*
+ *Function:	updateNode
+ *
+ *Description:	Recomputes the height and size of "node" from those of its children
+ *
+ *Complexity:	O(1)
+ *
+ */
 
-    return 1;
+static void updateNode (NODE *node) {
 
-  if (strcmp (node->data, item) > 0)
+  int left = height (node->left), right = height (node->right);
 
-    return hasNode (node->left, item);
+  node->height = (left > right ? left : right) + 1;
 
-  return hasNode (node->right, item);
+  node->size = size (node->left) + size (node->right) + 1;
 }
 
 
 /*
- *Function:	hasItem
+ *Function:	rotateLeft
  *
- *Description:	Returns one if "item" is present in "list," and zero otherwise
+ *Description:	Replaces the subtree at "link" by its right child, which takes the old root as
+ *		its left child
+ *
+ *Complexity:	O(1)
  *
- *Complexity:	Average: O(logn)
- *		Worst:   O(n)
  */
 
-int hasItem (LIST *list, char *item) {
+static void rotateLeft (NODE **link) {
 
-  return hasNode (list->root, item);
+  NODE *root = *link, *pivot = root->right;
+
+  root->right = pivot->left;
+
+  pivot->left = root;
+
+  updateNode (root);
+
+  updateNode (pivot);
+
+  *link = pivot;
 }
 
 
 /*
- *Function:	insertNode
+ *Function:	rotateRight
  *
- *Description:	Uses recursion to insert a new data node as a leaf in the BST
+ *Description:	Replaces the subtree at "link" by its left child, which takes the old root as
+ *		its right child
+ *
+ *Complexity:	O(1)
  *
- *Complexity:	Average: O(logn)
- *		Worst:   O(n)
  */
 
-static NODE *insertNode (NODE *root, NODE *new) {
+static void rotateRight (NODE **link) {
 
-  if (!root)					//NULL tree
+  NODE *root = *link, *pivot = root->left;
 
-    return new;
+  root->left = pivot->right;
 
+  pivot->right = root;
 
-  if (strcmp (new->data, root->data) < 0) {	//Locate null subtree for insertion
+  updateNode (root);
 
-    root->left = insertNode (root->left, new);
+  updateNode (pivot);
+
+  *link = pivot;
+}
 
-    return root;
-  }
 
-  else {						//new->data >= cur->data
+/*
+ *Function:	rebalance
+ *
+ *Description:	Walks back up the "depth" links on "path", from the deepest, after a node below
+ *		them was inserted or deleted, updating each height and size and rotating any node whose
+ *		subtrees now differ in height by two.  A child leaning the other way is rotated
+ *		first, turning the double imbalance into a single one.
+ *
+ *Complexity:	O(logn)
+ *
+ */
 
-    root->right = insertNode (root->right, new);
+static void rebalance (NODE ***path, int depth) {
 
-    return root;
-  }
+  NODE **link, *node;
+
+  int balance;
+
+  while (depth > 0) {
+
+    link = path[--depth];
+
+    node = *link;
 
-  return root;
+    balance = height (node->left) - height (node->right);
+
+    if (balance > 1) {				//Left heavy
+
+      if (height (node->left->left) < height (node->left->right))
+
+	rotateLeft (&node->left);
+
+      rotateRight (link);
+    }
+
+    else if (balance < -1) {			//Right heavy
+
+      if (height (node->right->right) < height (node->right->left))
+
+	rotateRight (&node->right);
+
+      rotateLeft (link);
+    }
+
+    else
+
+      updateNode (node);
+  }
 }
 
 
 /*
  *Function:	insertItem
  *
- *Description:	Inserts "item" into list, and returns whether list changed
+ *Description:	Inserts "item" into list as a new leaf, and returns whether list changed. An
+ *		item equal to one already present goes to its right.
+ *
+ *Complexity:	O(logn)
  *
- *Complexity:	Average: O(logn)
- *		Worst:   O(n)
  */
 
 int insertItem (LIST *list, char *item) {
 
-  NODE *new;
+  NODE *new, **link, **path[MAX_HEIGHT];
+
+  int depth = 0;
 
-  if ((new = malloc (sizeof(NODE))) == NULL)
+  if ((new = allocFromPool (&list->pool)) == NULL)
 
     return 0;
 
@@ -227,13 +343,22 @@ int insertItem (LIST *list, char *item) {
 
   new->data = item;
 
-  if (list->count == 0)
+  new->height = 1;
 
-    list->root = new;
+  new->size = 1;
+
+  link = &list->root;
+
+  while (*link) {				//Locate null subtree for insertion
+
+    path[depth++] = link;
+
+    link = strcmp (item, (*link)->data) < 0 ? &(*link)->left : &(*link)->right;
+  }
 
-  else
+  *link = new;
 
-    insertNode (list->root, new);
+  rebalance (path, depth);
 
   list->count++;
 
@@ -242,116 +367,202 @@ int insertItem (LIST *list, char *item) {
 
 
 /*
- *Function:	deleteNode
+ *Function:	deleteItem
+ *
+ *Description:	Deletes the first instance of "item" found in "list," and returns whether the
+ *		list changed.  A node with two children takes the item of its successor, the
+ *		leftmost node of its right subtree, and the successor's node is removed in its
+ *		place.  The item itself belongs to the caller and is not freed.
  *
- *Description:	Deletes node from BST and rebalances if needed
+ *Complexity:	O(logn)
  *
- *Complexity:	Average: O(logn)
- *		Worst:   O(n)
  */
 
-static NODE *deleteNode (NODE *root, char *data, int *success) {
+int deleteItem (LIST *list, char *item) {
+
+  NODE **link, **path[MAX_HEIGHT], *del;
+
+  int depth = 0, diff;
 
-  NODE *del;
-  NODE *exch;
-  NODE *newRoot;
-  char *temp;
+  link = &list->root;
 
-  if (!root)  {
+  while (*link && (diff = strcmp (item, (*link)->data)) != 0) {
 
-    *success = 0;
+    path[depth++] = link;
 
-    return NULL;			//Base Case 1: Empty tree
+    link = diff < 0 ? &(*link)->left : &(*link)->right;
   }
 
-  if (strcmp (data, root->data) < 0)
+  if (!*link)					//Not found
+
+    return 0;
+
+  if ((*link)->left && (*link)->right) {	//Two children: find the successor
+
+    del = *link;
+
+    path[depth++] = link;
 
-    root->left = deleteNode (root->left, data, success);
+    link = &del->right;
 
-  else if (strcmp (data, root->data) > 0)
+    while ((*link)->left) {
 
-    root->right = deleteNode (root->right, data, success);
+      path[depth++] = link;
 
-  else {					//Node found: (strcmp (data, root->data) = 0)
+      link = &(*link)->left;
+    }
+
+    del->data = (*link)->data;
+  }
 
-    del = root;			//Set "del" Node to the node to be deleted
+  del = *link;
 
-    if (!root->left) {		//No left child
+  *link = del->left ? del->left : del->right;
 
-      free (root->data);	//Empty data memory
+  returnToPool (&list->pool, del);
 
-      newRoot = root->right;
+  rebalance (path, depth);
 
-      free (del);
+  list->count--;
+
+  return 1;
+}
 
-      *success = 1;
 
-      return newRoot;		//Base case 2
+/*
+ *Function:	rangeItems
+ *
+ *Description:	Passes each item of "list" that is not less than "lo" and is less than "hi" to
+ *		"visit" in sorted order, along with "arg", and returns the number of items visited.
+ *		A NULL bound leaves that end of the range open. The traversal stops early once
+ *		"visit" returns zero. The list must not be changed during the traversal.
+ *
+ *		The traversal is inorder, with a stack of the nodes whose left subtrees are being
+ *		visited.  It starts by descending towards "lo", stacking only the nodes that are
+ *		not below it, so subtrees entirely below the range are never entered.
+ *
+ *Complexity:	O(logn + k), where k is the number of items visited
+ *
+ */
+
+int rangeItems (LIST *list, char *lo, char *hi, int (*visit) (char *item, void *arg), void *arg) {
+
+  NODE *node, *stack[MAX_HEIGHT];
+
+  int top = 0, visited = 0;
+
+  node = list->root;
+
+  while (node) {
+
+    if (lo && strcmp (node->data, lo) < 0)	//Node and left subtree below range
+
+      node = node->right;
+
+    else {
+
+      stack[top++] = node;
+
+      node = node->left;
     }
+  }
 
-    else
+  while (top > 0) {
+
+    node = stack[--top];
+
+    if (hi && strcmp (node->data, hi) >= 0)	//Node and everything after it above range
+
+      break;
+
+    visited++;
+
+    if (!visit (node->data, arg))
+
+      break;
 
-      if (!root->right) {	//Only left child
+    for (node = node->right; node; node = node->left)
 
-        newRoot = root->left;
+      stack[top++] = node;
+  }
+
+  return visited;
+}
 
-        free (del);
 
-        *success = 1;
+/*
+ *Function:	rankOf
+ *
+ *Description:	Returns the number of items in "list" less than "item," which is the position
+ *		"item" has or would have in sorted order, counting from zero.  Each step right
+ *		passes a node and its left subtree, whose sizes are added up on the way down.
+ *
+ *Complexity:	O(logn)
+ *
+ */
+
+int rankOf (LIST *list, char *item) {
 
-        return newRoot; //Base Case 3
-      }
+  NODE *node;
 
-      else {			//Delete node has two children
+  int rank = 0;
 
-        exch = root->left;
+  node = list->root;
 
-        while (exch->right)	//Find largest node in left subtree
+  while (node) {
 
-          exch = exch->right;
+    if (strcmp (node->data, item) < 0) {
 
-        temp = root->data;	//Exchange the data
+      rank += size (node->left) + 1;
 
-        root->data = exch->data;
+      node = node->right;
+    }
 
-        exch->data = temp;
+    else
 
-        root->left = deleteNode (root->left, exch->data, success);
-      }
+      node = node->left;
   }
 
-  return root;
+  return rank;
 }
 
+
 /*
- *Function:	deleteItem
+ *Function:	selectKth
  *
- *Description:	Deletes the first instance of "item" from "list," and returns whether the list changed.
+ *Description:	Returns the item at position "k" of "list" in sorted order, counting from zero,
+ *		or NULL if there is no such position.  The size of the left subtree of each node
+ *		tells whether the item is there, at the node, or in the right subtree.
+ *
+ *Complexity:	O(logn)
  *
- *Complexity:	Average: O(logn)
- *		Worst:   O(n)
  */
 
-int deleteItem (LIST *list, char *item) {
+char *selectKth (LIST *list, int k) {
 
-  int success;
+  NODE *node;
 
-  NODE *newRoot;
+  int left;
 
-  newRoot = deleteNode (list->root, item, &success);
+  if (k < 0 || k >= list->count)
 
-  if (success) {
+    return NULL;
+
+  node = list->root;
+
+  while ((left = size (node->left)) != k) {
 
-    list->root = newRoot;
+    if (k < left)
 
-    list->count--;
+      node = node->left;
 
-    if (list->count == 0)
+    else {
 
-      list->root = NULL;
+      k -= left + 1;
 
-    return 1;
+      node = node->right;
+    }
   }
 
-  return 0;
+  return node->data;
 }
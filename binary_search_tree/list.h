@@ -23,3 +23,9 @@ int hasItem (LIST *list, char *item);
 int insertItem (LIST *list, char *item);
 
 int deleteItem (LIST *list, char *item);
+
+int rangeItems (LIST *list, char *lo, char *hi, int (*visit) (char *item, void *arg), void *arg);
+
+int rankOf (LIST *list, char *item);
+
+char *selectKth (LIST *list, int k);
@@ -25,3 +25,10 @@ int insertElement (SET *set, char *elt);
 
 int deleteElement (SET *set, char *elt);
 
+int rangeScan (SET *set, char *lo, char *hi, int (*visit) (char *elt, void *arg), void *arg);
+
+int prefixScan (SET *set, char *prefix, int (*visit) (char *elt, void *arg), void *arg);
+
+int rankElement (SET *set, char *elt);
+
+char *selectElement (SET *set, int k);
@@ -0,0 +1,440 @@
+/*
+ * File:	set.c
+ *
+ * Description:	This file contains the implementation for a set abstract data type.
+ *              The algorithm used to implement the set is a chunked sorted array: the
+ *              sorted elements are stored in blocks of at most BLOCK_SIZE elements, each
+ *              a small sorted array of its own, and an index holds the blocks in order
+ *              along with a copy of the first element of each.
+ *
+ *              A search does a binary search over the first elements in the index,
+ *              then another within the one block found. An insertion or deletion only
+ *              shifts elements within that block. A full block is split in two, and a
+ *              block that drains below a quarter full is merged with a neighbour, or
+ *              shares its elements evenly with it if the two would not fit in one
+ *              block. The index grows by doubling, so the set has no capacity limit.
+ *
+ *              A set is an unordered collection of unique elements. Each element is a string.
+ *
+ */
+
+# include <stdio.h>
+# include <stdlib.h>
+# include <string.h>
+# include "set.h"
+
+# define BLOCK_SIZE 64 /* The largest number of elements in a block */
+
+/* A block of elements */
+typedef struct block
+{
+  int count; /* The number of elements in the block */
+
+  char *elts[BLOCK_SIZE]; /* The element strings, sorted */
+} BLOCK;
+
+/* Definition of the `set` data type */
+struct set
+{
+  int count; /* The number of elements currently in the set */
+
+  int blocks; /* The number of blocks */
+
+  int size; /* The number of blocks the index has room for */
+
+  BLOCK **index; /* The blocks in order */
+
+  char **firsts; /* The first element of each block */
+};
+
+/* Private function prototypes */
+static int locateBlock (SET *set, char *elt);
+static int locateElement (BLOCK *block, char *elt, int *found);
+static int addBlock (SET *set, int b);
+static void removeBlock (SET *set, int b);
+static void joinBlocks (SET *set, int b);
+
+/*
+ * Function:	locateBlock
+ *
+ * Description: Returns the block of `set` that holds `elt` or would hold it: the last
+ *		block whose first element is not greater than `elt`, or 0 if there is none.
+ *
+ * Complexity:  O(log(n/BLOCK_SIZE))
+ */
+static int locateBlock (SET *set, char *elt)
+{
+  int low, mid, high;
+
+  low = 1;
+
+  high = set->blocks - 1;
+
+  while (low <= high) {
+
+    mid = (low + high) / 2;
+
+    if (strcmp (set->firsts[mid], elt) <= 0)
+      low = mid + 1;
+    else
+      high = mid - 1;
+  }
+
+  return high > 0 ? high : 0;
+}
+
+/*
+ * Function:	locateElement
+ *
+ * Description: Returns the location of `elt` within `block` using binary search. If
+ *		element present: return its index, and set `found` pointer to 1. If element
+ *		not present, return the index of where it would have been, and set found
+ *		pointer to 0.
+ *
+ * Complexity:  O(log BLOCK_SIZE)
+ */
+static int locateElement (BLOCK *block, char *elt, int *found)
+{
+  int low, mid, high, diff;
+
+  low = 0;
+
+  high = block->count - 1;
+
+  while (low <= high) {
+
+    mid = (low + high) / 2;
+
+    diff = strcmp (elt, block->elts[mid]);
+
+    if (diff < 0)
+      high = mid - 1;
+
+    else if (diff > 0)
+      low = mid + 1;
+
+    else {
+      *found = 1;
+      return mid;
+    }
+  }
+
+  *found = 0;
+  return low;
+}
+
+/*
+ * Function:	addBlock
+ *
+ * Description: Inserts a new empty block into the index of `set` at position `b`, doubling
+ *		the index if it is full, and returns whether it succeeded. The first
+ *		element of the new block is left for the caller to set.
+ *
+ * Complexity:  O(n/BLOCK_SIZE)
+ */
+static int addBlock (SET *set, int b)
+{
+  BLOCK *block, **index;
+
+  char **firsts;
+
+  if (set->blocks == set->size) {
+
+    if ((index = realloc (set->index, set->size * 2 * sizeof(BLOCK *))) == NULL)
+      return 0;
+
+    set->index = index;
+
+    if ((firsts = realloc (set->firsts, set->size * 2 * sizeof(char *))) == NULL)
+      return 0;
+
+    set->firsts = firsts;
+
+    set->size *= 2;
+  }
+
+  if ((block = malloc (sizeof(BLOCK))) == NULL)
+    return 0;
+
+  block->count = 0;
+
+  memmove (set->index + b + 1, set->index + b, (set->blocks - b) * sizeof(BLOCK *));
+
+  memmove (set->firsts + b + 1, set->firsts + b, (set->blocks - b) * sizeof(char *));
+
+  set->index[b] = block;
+
+  set->blocks++;
+
+  return 1;
+}
+
+/*
+ * Function:	removeBlock
+ *
+ * Description: Deallocates block `b` of `set` and removes it from the index.
+ *
+ * Complexity:  O(n/BLOCK_SIZE)
+ */
+static void removeBlock (SET *set, int b)
+{
+  free (set->index[b]);
+
+  memmove (set->index + b, set->index + b + 1, (set->blocks - b - 1) * sizeof(BLOCK *));
+
+  memmove (set->firsts + b, set->firsts + b + 1, (set->blocks - b - 1) * sizeof(char *));
+
+  set->blocks--;
+}
+
+/*
+ * Function:	joinBlocks
+ *
+ * Description: Merges block `b` of `set` and the block after it into one if their elements
+ *		fit, or else moves elements between them until they hold equal shares.
+ *
+ * Complexity:  O(BLOCK_SIZE + n/BLOCK_SIZE)
+ */
+static void joinBlocks (SET *set, int b)
+{
+  BLOCK *left = set->index[b], *right = set->index[b + 1];
+
+  int move, total = left->count + right->count;
+
+  if (total <= BLOCK_SIZE) {
+    memcpy (left->elts + left->count, right->elts, right->count * sizeof(char *));
+    left->count = total;
+    removeBlock (set, b + 1);
+    return;
+  }
+
+  move = total / 2 - left->count;
+
+  if (move > 0) {
+    memcpy (left->elts + left->count, right->elts, move * sizeof(char *));
+    memmove (right->elts, right->elts + move, (right->count - move) * sizeof(char *));
+  }
+
+  else {
+    memmove (right->elts - move, right->elts, right->count * sizeof(char *));
+    memcpy (right->elts, left->elts + left->count + move, -move * sizeof(char *));
+  }
+
+  left->count += move;
+
+  right->count -= move;
+
+  set->firsts[b + 1] = right->elts[0];
+}
+
+/*
+ * Function:	createSet
+ *
+ * Description: Initializes and returns an empty set. The set grows as elements are
+ *		inserted, so `size` is only used to size the index up front.
+ *
+ * Complexity:  O(1)
+ */
+SET *createSet (int size)
+{
+  SET *s;
+
+  s = malloc (sizeof(SET));
+
+  if (s == NULL)
+    return NULL;
+
+  s->count = 0;
+
+  s->blocks = 0;
+
+  s->size = size / BLOCK_SIZE > 0 ? size / BLOCK_SIZE : 1;
+
+  s->index = malloc (s->size * sizeof(BLOCK *));
+
+  s->firsts = malloc (s->size * sizeof(char *));
+
+  if (s->index == NULL || s->firsts == NULL) {
+    free (s->index);
+    free (s->firsts);
+    free (s);
+    return NULL;
+  }
+
+  return s;
+}
+
+/*
+ * Function:	numElements
+ *
+ * Description:	Returns the number of elements in `set`.
+ *
+ * Complexity:  O(1)
+ */
+int numElements (SET *set)
+{
+  return set->count;
+}
+
+/*
+ * Function:    hasElement
+ *
+ * Description: Returns whether `elt` is a member of `set`.
+ *
+ * Complexity:  O(logn)
+ */
+int hasElement (SET *set, char *elt)
+{
+  int found;
+
+  if (set->blocks == 0)
+    return 0;
+
+  locateElement (set->index[locateBlock (set, elt)], elt, &found);
+
+  return found;
+}
+
+/*
+ * Function:	insertElement
+ *
+ * Description: Inserts `elt` into `set`, and returns whether the set changed. If the
+ *		block `elt` belongs in is full, it is split in two first. If it is the
+ *		last block and `elt` goes after all of its elements, a new block is
+ *		started instead, so that input in sorted order fills its blocks.
+ *
+ * Complexity:  O(logn) - if `elt` is already present
+ *		O(BLOCK_SIZE + n/BLOCK_SIZE) - if `elt` not already present
+ */
+int insertElement (SET *set, char *elt)
+{
+  BLOCK *block;
+
+  int b, locn, found, half;
+
+  if (set->blocks == 0) {
+    if (!addBlock (set, 0))
+      return 0;
+    set->firsts[0] = elt;
+  }
+
+  b = locateBlock (set, elt);
+
+  block = set->index[b];
+
+  locn = locateElement (block, elt, &found);
+
+  if (found)
+    return 0;
+
+  if (block->count == BLOCK_SIZE) {
+
+    if (!addBlock (set, b + 1))
+      return 0;
+
+    if (b + 2 == set->blocks && locn == BLOCK_SIZE)
+      half = BLOCK_SIZE;
+    else
+      half = BLOCK_SIZE / 2;
+
+    memcpy (set->index[b + 1]->elts, block->elts + half, (BLOCK_SIZE - half) * sizeof(char *));
+
+    set->index[b + 1]->count = BLOCK_SIZE - half;
+
+    if (half < BLOCK_SIZE)
+      set->firsts[b + 1] = block->elts[half];
+
+    block->count = half;
+
+    if (locn >= half) {
+      b++;
+      block = set->index[b];
+      locn -= half;
+    }
+  }
+
+  /* Ensure that the block remains sorted: */
+
+  memmove (block->elts + locn + 1, block->elts + locn, (block->count - locn) * sizeof(char *));
+
+  block->elts[locn] = elt;
+
+  block->count++;
+
+  set->firsts[b] = block->elts[0];
+
+  set->count++;
+
+  return 1;
+}
+
+/*
+ * Function:    deleteElement
+ *
+ * Description: Deletes `elt` from `set`, and returns whether the set changed. A block
+ *		left less than a quarter full is joined with a neighbour, and an empty one
+ *		is removed.
+ *
+ * Complexity:  O(logn) - if element not present
+ *		O(BLOCK_SIZE + n/BLOCK_SIZE) - if element is present
+ */
+int deleteElement (SET *set, char *elt)
+{
+  BLOCK *block;
+
+  int b, locn, found;
+
+  if (set->blocks == 0)
+    return 0;
+
+  b = locateBlock (set, elt);
+
+  block = set->index[b];
+
+  locn = locateElement (block, elt, &found);
+
+  if (!found)
+    return 0;
+
+  memmove (block->elts + locn, block->elts + locn + 1, (block->count - locn - 1) * sizeof(char *));
+
+  block->count--;
+
+  set->count--;
+
+  if (block->count == 0)
+    removeBlock (set, b);
+
+  else {
+
+    set->firsts[b] = block->elts[0];
+
+    if (block->count < BLOCK_SIZE / 4 && set->blocks > 1)
+      joinBlocks (set, b + 1 < set->blocks ? b : b - 1);
+  }
+
+  return 1;
+}
+
+/*
+ * Function:    destroySet
+ *
+ * Description: Deallocates memory associated with `set`.
+ *
+ * Complexity:  O(n/BLOCK_SIZE)
+ */
+void destroySet (SET *set)
+{
+  int b;
+
+  for (b = 0; b < set->blocks; b++)
+    free (set->index[b]);
+
+  free (set->firsts);
+
+  free (set->index);
+
+  free (set);
+
+  return;
+}
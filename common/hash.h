@@ -0,0 +1,173 @@
+/*
+ * File:	hash.h
+ *
+ * Description:	This file contains the string hash function shared by the hash table
+ *              implementations. It follows the design of wyhash: the string is read
+ *              eight bytes at a time and each pair of words is combined with a single
+ *              64 by 64 bit multiplication, folding the high half of the product into
+ *              the low half. Every bit of the result depends on every input bit, so
+ *              tables can take the low bits of the hash with a mask rather than
+ *              dividing by a prime size.
+ *
+ *              The functions are defined static so that each implementation can include
+ *              this header directly and still be built with `gcc *.c`.
+ *
+ */
+
+# include <string.h>
+
+# define HASH_P0 0xa0761d6478bd642fULL
+# define HASH_P1 0xe7037ed1a0b428dbULL
+# define HASH_P2 0x8ebc6af09c88c6e3ULL
+# define HASH_P3 0x589965cc75374cc3ULL
+
+/*
+ * Function:	hashMultiply
+ *
+ * Description: Replaces `a` and `b` with the low and high halves of their 128 bit product.
+ *
+ * Complexity:  O(1)
+ */
+static inline void hashMultiply (unsigned long long *a, unsigned long long *b)
+{
+# ifdef __SIZEOF_INT128__
+  __uint128_t r = (__uint128_t) *a * *b;
+
+  *a = (unsigned long long) r;
+
+  *b = (unsigned long long) (r >> 64);
+# else
+  unsigned long long ha = *a >> 32, hb = *b >> 32, la = (unsigned) *a, lb = (unsigned) *b;
+  unsigned long long rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+  unsigned long long t = rl + (rm0 << 32), c = t < rl, lo, hi;
+
+  lo = t + (rm1 << 32);
+  c += lo < t;
+  hi = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+
+  *a = lo;
+
+  *b = hi;
+# endif
+}
+
+/*
+ * Function:	hashMix
+ *
+ * Description: Returns the exclusive or of the two halves of the product of `a` and `b`.
+ *
+ * Complexity:  O(1)
+ */
+static inline unsigned long long hashMix (unsigned long long a, unsigned long long b)
+{
+  hashMultiply (&a, &b);
+
+  return a ^ b;
+}
+
+/*
+ * Function:	hashRead8, hashRead4
+ *
+ * Description: Return the eight or four bytes at `p` as an integer, without requiring
+ *		`p` to be aligned.
+ *
+ * Complexity:  O(1)
+ */
+static inline unsigned long long hashRead8 (const unsigned char *p)
+{
+  unsigned long long v;
+
+  memcpy (&v, p, sizeof(v));
+
+  return v;
+}
+
+static inline unsigned long long hashRead4 (const unsigned char *p)
+{
+  unsigned v;
+
+  memcpy (&v, p, sizeof(v));
+
+  return v;
+}
+
+/*
+ * Function:	hashBytes
+ *
+ * Description: Returns the 64 bit hash of the `len` bytes at `key`.
+ *
+ * Complexity:  O(len)
+ */
+static inline unsigned long long hashBytes (const void *key, size_t len)
+{
+  const unsigned char *p = key;
+
+  unsigned long long a, b, seed, see1, see2;
+
+  size_t i = len;
+
+  seed = hashMix (HASH_P0, HASH_P1);
+
+  if (len <= 16) {
+
+    if (len >= 4) {
+      a = (hashRead4 (p) << 32) | hashRead4 (p + ((len >> 3) << 2));
+      b = (hashRead4 (p + len - 4) << 32) | hashRead4 (p + len - 4 - ((len >> 3) << 2));
+    }
+
+    else if (len > 0) {
+      a = ((unsigned long long) p[0] << 16) | ((unsigned long long) p[len >> 1] << 8) | p[len - 1];
+      b = 0;
+    }
+
+    else
+      a = b = 0;
+  }
+
+  else {
+
+    if (i > 48) {
+
+      see1 = see2 = seed;
+
+      do {
+        seed = hashMix (hashRead8 (p) ^ HASH_P1, hashRead8 (p + 8) ^ seed);
+        see1 = hashMix (hashRead8 (p + 16) ^ HASH_P2, hashRead8 (p + 24) ^ see1);
+        see2 = hashMix (hashRead8 (p + 32) ^ HASH_P3, hashRead8 (p + 40) ^ see2);
+        p += 48;
+        i -= 48;
+      } while (i > 48);
+
+      seed ^= see1 ^ see2;
+    }
+
+    while (i > 16) {
+      seed = hashMix (hashRead8 (p) ^ HASH_P1, hashRead8 (p + 8) ^ seed);
+      p += 16;
+      i -= 16;
+    }
+
+    a = hashRead8 (p + i - 16);
+    b = hashRead8 (p + i - 8);
+  }
+
+  a ^= HASH_P1;
+
+  b ^= seed;
+
+  hashMultiply (&a, &b);
+
+  return hashMix (a ^ HASH_P0 ^ len, b ^ HASH_P1);
+}
+
+/*
+ * Function:	hashString
+ *
+ * Description: Returns the 64 bit hash of the string `s`.
+ *
+ * Complexity:  O(k) - k is the length of `s`
+ */
+static inline unsigned long long hashString (const char *s)
+{
+  return hashBytes (s, strlen (s));
+}
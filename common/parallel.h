@@ -0,0 +1,57 @@
+/*
+ * File:	parallel.h
+ *
+ * Description:	This file contains a helper that runs one function over an array of jobs,
+ *              each on its own thread, and waits for all of them. The implementations
+ *              that build a set from an array of keys use it to split the work.
+ *
+ *              If a thread cannot be created its job is run on the calling thread
+ *              instead, so the work is always completed. Programs using it need to be
+ *              built with `gcc -pthread`.
+ *
+ */
+
+# include <stdlib.h>
+# include <pthread.h>
+
+/*
+ * Function:	runParallel
+ *
+ * Description: Calls `work` on each of the `count` jobs in `jobs`, which are `size` bytes
+ *		apart, on separate threads, and returns once every call has finished.
+ *
+ * Complexity:  O(count) - plus the cost of the slowest job
+ */
+static inline void runParallel (void *(*work) (void *), void *jobs, size_t size, int count)
+{
+  int i;
+
+  char *job = jobs;
+
+  pthread_t *tids;
+
+  char *started;
+
+  tids = malloc (count * sizeof(pthread_t));
+
+  started = calloc (count, sizeof(char));
+
+  /* The calling thread runs the first job itself, after starting the others. */
+
+  for (i = 1; i < count; i++)
+    if (tids != NULL && started != NULL &&
+	pthread_create (&tids[i], NULL, work, job + i * size) == 0)
+      started[i] = 1;
+
+  for (i = 0; i < count; i++)
+    if (started == NULL || !started[i])
+      work (job + i * size);
+
+  for (i = 1; i < count; i++)
+    if (started != NULL && started[i])
+      pthread_join (tids[i], NULL);
+
+  free (started);
+
+  free (tids);
+}
@@ -0,0 +1,234 @@
+/*
+ * File:	pool.h
+ *
+ * Description:	This file contains a pool allocator for the nodes of the list
+ *              implementations. A pool hands out objects of one size carved from
+ *              slabs, large blocks allocated with malloc, so that nodes allocated
+ *              together lie together in memory and most allocations only advance a
+ *              pointer. Returned objects are kept on a free list and handed out again
+ *              first. Releasing the pool frees its slabs, and with them every object,
+ *              without visiting the objects one by one.
+ *
+ *              The first slab holds POOL_FIRST objects and each later slab twice as
+ *              many as the one before, up to POOL_LIMIT, so a pool for a short list
+ *              stays small and one for a long list needs few slabs. A pool is not
+ *              safe to use from several threads at once; each list has its own.
+ *
+ *              Defining POOL_MALLOC makes a pool allocate and free each object with
+ *              malloc instead, keeping them on a list so that releasing the pool can
+ *              still free them all. This lets tools such as valgrind see each node,
+ *              and is the baseline benchmarks/pool_bench.c compares the pool with.
+ *
+ */
+
+# include <stdlib.h>
+
+# define POOL_FIRST 8 /* The number of objects in the first slab of a pool */
+# define POOL_LIMIT 1024 /* The largest number of objects in a slab */
+
+/* A slab, which is followed in memory by its objects, each aligned as a pointer */
+typedef struct slab
+{
+  struct slab *next; /* The slab allocated before this one */
+
+  struct slab *prev; /* The slab allocated after this one, used only with POOL_MALLOC */
+} SLAB;
+
+/* Definition of the `pool` data type */
+typedef struct pool
+{
+  size_t size; /* The size of each object, a multiple of the size of a pointer */
+
+  int objects; /* The number of objects in the newest slab */
+
+  SLAB *slabs; /* The newest slab, which links to the older ones */
+
+  char *next; /* The next object never handed out in the newest slab */
+
+  char *end; /* The end of the newest slab */
+
+  void *free; /* The returned objects, each holding a pointer to the next */
+} POOL;
+
+/*
+ * Function:	initPool
+ *
+ * Description: Initializes `pool` to hand out objects of `size` bytes. No memory is
+ *		allocated until the first object is.
+ *
+ * Complexity:  O(1)
+ */
+static inline void initPool (POOL *pool, size_t size)
+{
+  if (size < sizeof(void *))
+    size = sizeof(void *);
+
+  pool->size = (size + sizeof(void *) - 1) / sizeof(void *) * sizeof(void *);
+
+  pool->objects = 0;
+
+  pool->slabs = NULL;
+
+  pool->next = pool->end = NULL;
+
+  pool->free = NULL;
+}
+
+# ifndef POOL_MALLOC
+
+/*
+ * Function:	allocFromPool
+ *
+ * Description: Returns an uninitialized object from `pool`, or NULL if out of memory. A
+ *		returned object is reused if there is one, else the newest slab is carved
+ *		further, else a new slab is allocated.
+ *
+ * Complexity:  O(1)
+ */
+static inline void *allocFromPool (POOL *pool)
+{
+  SLAB *slab;
+
+  void *object;
+
+  int objects;
+
+  if (pool->free != NULL) {
+    object = pool->free;
+    pool->free = *(void **) object;
+    return object;
+  }
+
+  if (pool->next == pool->end) {
+
+    objects = pool->objects == 0 ? POOL_FIRST : pool->objects * 2;
+
+    if (objects > POOL_LIMIT)
+      objects = POOL_LIMIT;
+
+    if ((slab = malloc (sizeof(SLAB) + objects * pool->size)) == NULL)
+      return NULL;
+
+    slab->next = pool->slabs;
+
+    pool->slabs = slab;
+
+    pool->objects = objects;
+
+    pool->next = (char *) (slab + 1);
+
+    pool->end = pool->next + objects * pool->size;
+  }
+
+  object = pool->next;
+
+  pool->next += pool->size;
+
+  return object;
+}
+
+/*
+ * Function:	returnToPool
+ *
+ * Description: Gives `object`, which came from `pool`, back to it for reuse.
+ *
+ * Complexity:  O(1)
+ */
+static inline void returnToPool (POOL *pool, void *object)
+{
+  *(void **) object = pool->free;
+
+  pool->free = object;
+}
+
+/*
+ * Function:	releasePool
+ *
+ * Description: Frees every slab of `pool`, and with them every object it handed out, and
+ *		leaves it empty and ready for use again.
+ *
+ * Complexity:  O(s), where s is the number of slabs
+ */
+static inline void releasePool (POOL *pool)
+{
+  SLAB *slab;
+
+  while ((slab = pool->slabs) != NULL) {
+    pool->slabs = slab->next;
+    free (slab);
+  }
+
+  initPool (pool, pool->size);
+}
+
+# else
+
+/*
+ * Function:	allocFromPool
+ *
+ * Description: Returns an uninitialized object allocated with malloc, or NULL if out of
+ *		memory. The object follows a header linking it into the list of `pool`.
+ *
+ * Complexity:  O(1)
+ */
+static inline void *allocFromPool (POOL *pool)
+{
+  SLAB *slab;
+
+  if ((slab = malloc (sizeof(SLAB) + pool->size)) == NULL)
+    return NULL;
+
+  slab->next = pool->slabs;
+
+  slab->prev = NULL;
+
+  if (pool->slabs != NULL)
+    pool->slabs->prev = slab;
+
+  pool->slabs = slab;
+
+  return slab + 1;
+}
+
+/*
+ * Function:	returnToPool
+ *
+ * Description: Unlinks `object` from the list of `pool` and frees it.
+ *
+ * Complexity:  O(1)
+ */
+static inline void returnToPool (POOL *pool, void *object)
+{
+  SLAB *slab = (SLAB *) object - 1;
+
+  if (slab->prev != NULL)
+    slab->prev->next = slab->next;
+  else
+    pool->slabs = slab->next;
+
+  if (slab->next != NULL)
+    slab->next->prev = slab->prev;
+
+  free (slab);
+}
+
+/*
+ * Function:	releasePool
+ *
+ * Description: Frees every object still on the list of `pool`, and leaves it empty.
+ *
+ * Complexity:  O(n)
+ */
+static inline void releasePool (POOL *pool)
+{
+  SLAB *slab;
+
+  while ((slab = pool->slabs) != NULL) {
+    pool->slabs = slab->next;
+    free (slab);
+  }
+
+  initPool (pool, pool->size);
+}
+
+# endif
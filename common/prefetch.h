@@ -0,0 +1,14 @@
+/*
+ * File:	prefetch.h
+ *
+ * Description:	This file contains the PREFETCH macro, which asks the processor to start
+ *              loading the cache line holding an address that will be read soon. It
+ *              does nothing with compilers that offer no way to do so.
+ *
+ */
+
+# ifdef __GNUC__
+# define PREFETCH(p) __builtin_prefetch (p)
+# else
+# define PREFETCH(p) ((void) (p))
+# endif
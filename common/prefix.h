@@ -0,0 +1,36 @@
+/*
+ * File:	prefix.h
+ *
+ * Description:	This file contains the key prefix function shared by the ordered
+ *              implementations that compare strings as integers first. The prefix of a
+ *              string is its first eight bytes, so that a search can compare most keys
+ *              without following a pointer to them, and fall back to strcmp only for
+ *              keys whose prefixes are equal.
+ *
+ */
+
+/*
+ * Function:	prefixOf
+ *
+ * Description: Returns the first eight bytes of `elt`, padded with NULs, as a big-endian
+ *		integer. Comparing the prefixes of two strings as integers orders them as
+ *		strcmp does, unless the prefixes are equal.
+ *
+ * Complexity:  O(1)
+ */
+static inline unsigned long long prefixOf (char *elt)
+{
+  unsigned long long prefix = 0;
+
+  int i;
+
+  for (i = 0; i < 8; i++) {
+
+    prefix <<= 8;
+
+    if (*elt != '\0')
+      prefix |= (unsigned char) *elt++;
+  }
+
+  return prefix;
+}
@@ -0,0 +1,762 @@
+/*
+ * File:	set.c
+ *
+ * Description:	This file contains the implementation for a set abstract data type that
+ *              may be shared by several threads without any locking. The algorithm used
+ *              is a hash table with linear probing whose slots are updated only with
+ *              atomic compare-and-swap operations: no operation waits for another
+ *              thread, and one only retries when another thread changed the slot it
+ *              was about to change.
+ *
+ *              Within one table, a slot is claimed for a string the first time an equal
+ *              string is inserted, and from then on identifies that string. Deleting the
+ *              element sets a tag bit in the slot, and inserting an equal string again
+ *              clears it, so threads inserting the same string always race for the same
+ *              slot and can never store it twice. A thread reserves a slot in the count
+ *              of claimed slots before claiming it, and gives the reservation back if it
+ *              loses the race, so that no more than half the slots are ever claimed and
+ *              every search ends at an unused one.
+ *
+ *              Once half the slots are claimed, the table is replaced by a new one, twice
+ *              as large if more than a quarter of them hold elements and otherwise the
+ *              same size. Any thread that finds a resize in progress helps with it before
+ *              going on: each slot is frozen with a second tag bit, so that no update can
+ *              change it any more, and its element, if it has one, is copied into the new
+ *              table. Deleted elements are not copied, which frees their slots for other
+ *              strings. The threads first share out the slots a chunk at a time, then
+ *              each makes sure every slot was moved before making the new table current.
+ *
+ *              The set owns the strings it stores. A string that no slot refers to any
+ *              more, because it was deleted and then dropped by a resize or replaced by
+ *              an equal string inserted again, is freed once no thread can still be
+ *              comparing against it, and so is a table once it has been replaced. This
+ *              uses epoch-based reclamation: each thread announces the global epoch
+ *              while it is inside an operation, the epoch only advances once every busy
+ *              thread has seen it, and memory is freed two epochs after it was retired.
+ *              The remaining strings are freed by `destroySet`, which must not run
+ *              concurrently with any other operation.
+ *
+ *              Determining membership, insertion and deletion have constant time for the
+ *              average case.
+ *
+ *              A set is an unordered collection of unique elements. Each element is a string.
+ *
+ */
+
+# include <stdio.h>
+# include <stdlib.h>
+# include <string.h>
+# include <stdint.h>
+# include <stdatomic.h>
+# include <pthread.h>
+# include "set.h"
+# include "../common/hash.h"
+
+# define DELETED ((uintptr_t) 1) /* Tag bit of a slot whose element was deleted */
+# define MOVED ((uintptr_t) 2) /* Tag bit of a slot frozen by a resize, alone once it was moved */
+# define MIN_SIZE 16 /* The smallest array ever allocated */
+# define MOVE_CHUNK 1024 /* Number of slots a thread helping with a resize moves at a time */
+# define RECLAIM_PERIOD 64 /* Number of retired strings or tables between attempts to free some */
+
+/* Definition of a string or table waiting to be freed */
+typedef struct retired
+{
+  void *ptr; /* The retired memory */
+
+  unsigned epoch; /* The global epoch when it was retired */
+
+  struct retired *next;
+} RETIRED;
+
+/* Definition of the per-thread reclamation state */
+typedef struct record
+{
+  atomic_uint epoch; /* The global epoch seen when the current operation started */
+
+  atomic_int active; /* Whether the thread is inside an operation on the set */
+
+  pthread_t owner; /* The thread using this record */
+
+  RETIRED *limbo; /* Memory retired by this thread and not yet freed */
+
+  int pending; /* The number of strings in `limbo` */
+
+  struct record *next;
+} RECORD;
+
+/* Definition of one hash table */
+typedef struct table
+{
+  int size; /* The number of slots, a power of two */
+
+  atomic_int claimed; /* The number of slots holding a string, present or deleted, or reserved */
+
+  atomic_int chunk; /* The first slot not yet handed to a thread helping with a resize */
+
+  _Atomic (struct table *) next; /* The table a resize is moving the elements to, or NULL */
+
+  _Atomic (uintptr_t) slots[]; /* The string of each slot, tagged when deleted, or 0 if unused */
+} TABLE;
+
+/* Definition of the `set` data type */
+struct set
+{
+  atomic_int count; /* The number of elements currently in the set */
+
+  _Atomic (TABLE *) table; /* The current table */
+
+  atomic_uint epoch; /* The global reclamation epoch */
+
+  _Atomic (RECORD *) records; /* The reclamation state of every thread that used the set */
+
+  unsigned id; /* Distinguishes this set from earlier ones allocated at the same address */
+};
+
+/* Identifies sets to the per-thread record cache */
+static atomic_uint lastId;
+
+/* The record this thread used last, and the set it belongs to */
+static _Thread_local RECORD *cachedRecord;
+static _Thread_local SET *cachedSet;
+static _Thread_local unsigned cachedId;
+
+/* Private function prototypes */
+static RECORD *enterSet (SET *set);
+static void leaveSet (RECORD *rec);
+static void retireMemory (SET *set, RECORD *rec, void *ptr);
+static void reclaimMemory (SET *set, RECORD *rec);
+static TABLE *createTable (int size);
+static void copyElement (TABLE *t, char *elt);
+static void moveSlot (SET *set, RECORD *rec, TABLE *t, TABLE *next, int i);
+static TABLE *resizeTable (SET *set, RECORD *rec, TABLE *t);
+
+/*
+ * Function:	enterSet
+ *
+ * Description: Marks the calling thread as inside an operation on `set`, and returns its
+ *		reclamation record, creating it on the thread's first operation. Returns
+ *		NULL if the record could not be allocated.
+ *
+ * Complexity:  O(1) - once the thread has a record
+ *		O(t) - otherwise, where t is the number of threads that used the set
+ */
+static RECORD *enterSet (SET *set)
+{
+  RECORD *rec;
+
+  if (cachedSet != set || cachedId != set->id) {
+
+    for (rec = atomic_load (&set->records); rec != NULL; rec = rec->next)
+      if (pthread_equal (rec->owner, pthread_self ()))
+        break;
+
+    if (rec == NULL) {
+
+      if ((rec = malloc (sizeof(RECORD))) == NULL)
+        return NULL;
+
+      atomic_init (&rec->epoch, 0);
+
+      atomic_init (&rec->active, 0);
+
+      rec->owner = pthread_self ();
+
+      rec->limbo = NULL;
+
+      rec->pending = 0;
+
+      rec->next = atomic_load (&set->records);
+
+      while (!atomic_compare_exchange_weak (&set->records, &rec->next, rec))
+        ;
+    }
+
+    cachedRecord = rec;
+
+    cachedSet = set;
+
+    cachedId = set->id;
+  }
+
+  rec = cachedRecord;
+
+  atomic_store (&rec->active, 1);
+
+  atomic_store (&rec->epoch, atomic_load (&set->epoch));
+
+  return rec;
+}
+
+/*
+ * Function:	leaveSet
+ *
+ * Description: Marks the thread owning `rec` as no longer inside an operation.
+ *
+ * Complexity:  O(1)
+ */
+static void leaveSet (RECORD *rec)
+{
+  atomic_store (&rec->active, 0);
+}
+
+/*
+ * Function:	retireMemory
+ *
+ * Description: Schedules `ptr`, a string that no slot refers to any more or a table that
+ *		was replaced, to be freed once every thread that might still be reading it
+ *		has finished its operation.
+ *
+ * Complexity:  O(1) - amortized, when the other threads keep making progress
+ */
+static void retireMemory (SET *set, RECORD *rec, void *ptr)
+{
+  RETIRED *r;
+
+  if ((r = malloc (sizeof(RETIRED))) == NULL)
+    return; /* Leak the memory rather than free it too early */
+
+  r->ptr = ptr;
+
+  r->epoch = atomic_load (&set->epoch);
+
+  r->next = rec->limbo;
+
+  rec->limbo = r;
+
+  if (++rec->pending % RECLAIM_PERIOD == 0)
+    reclaimMemory (set, rec);
+}
+
+/*
+ * Function:	reclaimMemory
+ *
+ * Description: Advances the global epoch if every thread inside an operation has seen
+ *		it, then frees the memory in `rec`'s limbo list that was retired at least
+ *		two epochs ago.
+ *
+ * Complexity:  O(t + r) - t is the number of threads, r the length of the limbo list
+ */
+static void reclaimMemory (SET *set, RECORD *rec)
+{
+  unsigned epoch;
+
+  RECORD *other;
+
+  RETIRED **pre, *r;
+
+  epoch = atomic_load (&set->epoch);
+
+  for (other = atomic_load (&set->records); other != NULL; other = other->next)
+    if (atomic_load (&other->active) && atomic_load (&other->epoch) != epoch)
+      break;
+
+  if (other == NULL && atomic_compare_exchange_strong (&set->epoch, &epoch, epoch + 1))
+    epoch++;
+
+  pre = &rec->limbo;
+
+  while ((r = *pre) != NULL) {
+
+    if (epoch - r->epoch >= 2) {
+      *pre = r->next;
+      free (r->ptr);
+      free (r);
+      rec->pending--;
+    }
+
+    else
+      pre = &r->next;
+  }
+}
+
+/*
+ * Function:	createTable
+ *
+ * Description: Returns a new table of `size` unused slots, or NULL if out of memory.
+ *
+ * Complexity:  O(n)
+ */
+static TABLE *createTable (int size)
+{
+  int i;
+
+  TABLE *t;
+
+  t = malloc (sizeof(TABLE) + size * sizeof(t->slots[0]));
+
+  if (t == NULL)
+    return NULL;
+
+  t->size = size;
+
+  atomic_init (&t->claimed, 0);
+
+  atomic_init (&t->chunk, 0);
+
+  atomic_init (&t->next, NULL);
+
+  for (i = 0; i < size; i++)
+    atomic_init (&t->slots[i], 0);
+
+  return t;
+}
+
+/*
+ * Function:	copyElement
+ *
+ * Description: Places `elt`, which a resize is moving, in the new table `t` unless
+ *		another thread helping with the resize already did. Only moved elements
+ *		are inserted into `t` until the resize ends, so there is always an unused
+ *		slot for it. Once the resize has ended, `t` may hold an equal string that
+ *		replaced `elt`, perhaps deleted, and may itself be being resized, and in
+ *		either case `elt` was moved already.
+ *
+ * Complexity:  O(1) - average case
+ */
+static void copyElement (TABLE *t, char *elt)
+{
+  int locn;
+
+  uintptr_t slot;
+
+  locn = hashString (elt) & (t->size - 1);
+
+  for (;;) {
+
+    slot = atomic_load (&t->slots[locn]);
+
+    if (slot & MOVED)
+      return;
+
+    if (slot == 0) {
+
+      if (atomic_compare_exchange_strong (&t->slots[locn], &slot, (uintptr_t) elt)) {
+        atomic_fetch_add (&t->claimed, 1);
+        return;
+      }
+
+      continue;
+    }
+
+    if ((slot & ~DELETED) == (uintptr_t) elt || strcmp ((char *) (slot & ~DELETED), elt) == 0)
+      return;
+
+    locn = (locn + 1) & (t->size - 1);
+  }
+}
+
+/*
+ * Function:	moveSlot
+ *
+ * Description: Freezes slot `i` of `t`, copies its element to `next` unless it was
+ *		deleted, and marks the slot as moved. Whichever thread marks the slot
+ *		retires the string of a deleted element, which no table refers to after.
+ *
+ * Complexity:  O(1) - average case
+ */
+static void moveSlot (SET *set, RECORD *rec, TABLE *t, TABLE *next, int i)
+{
+  uintptr_t slot;
+
+  slot = atomic_load (&t->slots[i]);
+
+  while (!(slot & MOVED))
+    if (atomic_compare_exchange_weak (&t->slots[i], &slot, slot | MOVED))
+      slot |= MOVED;
+
+  if (slot == MOVED)
+    return;
+
+  if (!(slot & DELETED))
+    copyElement (next, (char *) (slot & ~MOVED));
+
+  if (atomic_compare_exchange_strong (&t->slots[i], &slot, MOVED) && (slot & DELETED))
+    retireMemory (set, rec, (char *) (slot & ~(DELETED | MOVED)));
+}
+
+/*
+ * Function:	resizeTable
+ *
+ * Description: Starts a resize of `t` unless one is in progress, helps to move its slots
+ *		until every one has been moved, and returns the current table after it.
+ *		The new table is twice as large if more than a quarter of the slots of
+ *		`t` hold elements, and otherwise the same size, so that no more than half
+ *		of it is claimed by the elements moved. Returns NULL, leaving `set`
+ *		unchanged, if the new table could not be allocated.
+ *
+ * Complexity:  O(n)
+ */
+static TABLE *resizeTable (SET *set, RECORD *rec, TABLE *t)
+{
+  int i, chunk, size;
+
+  TABLE *next, *expected = NULL;
+
+  if ((next = atomic_load (&t->next)) == NULL) {
+
+    size = t->size;
+
+    if (atomic_load (&set->count) * 4 > size)
+      size *= 2;
+
+    if ((next = createTable (size)) == NULL)
+      return NULL;
+
+    if (!atomic_compare_exchange_strong (&t->next, &expected, next)) {
+      free (next); /* Another thread started the resize first */
+      next = expected;
+    }
+  }
+
+  while (atomic_load (&t->chunk) < t->size &&
+         (chunk = atomic_fetch_add (&t->chunk, MOVE_CHUNK)) < t->size)
+    for (i = chunk; i < chunk + MOVE_CHUNK && i < t->size; i++)
+      moveSlot (set, rec, t, next, i);
+
+  for (i = 0; i < t->size; i++) /* Finish any chunk whose thread was held up */
+    moveSlot (set, rec, t, next, i);
+
+  expected = t;
+
+  if (atomic_compare_exchange_strong (&set->table, &expected, next))
+    retireMemory (set, rec, t);
+
+  return atomic_load (&set->table);
+}
+
+/*
+ * Function:	createSet
+ *
+ * Description: Initializes and returns an empty set with an initial capacity of at least
+ *		`size` elements. The set grows as elements are inserted.
+ *
+ * Complexity:  O(n)
+ */
+SET *createSet (int size)
+{
+  SET *s;
+
+  TABLE *t;
+
+  int slots = MIN_SIZE;
+
+  while (slots < size * 2)
+    slots *= 2;
+
+  s = malloc (sizeof(SET));
+
+  if (s == NULL)
+    return NULL;
+
+  if ((t = createTable (slots)) == NULL) {
+    free (s);
+    return NULL;
+  }
+
+  atomic_init (&s->table, t);
+
+  atomic_init (&s->count, 0);
+
+  atomic_init (&s->epoch, 0);
+
+  atomic_init (&s->records, NULL);
+
+  s->id = atomic_fetch_add (&lastId, 1) + 1;
+
+  return s;
+}
+
+/*
+ * Function:	insertElement
+ *
+ * Description: Inserts `elt` into `set`, and returns whether the set changed. If it did,
+ *		the set now owns `elt`. Returns 0 if an equal string is present, or if
+ *		the table had to be resized and the new one could not be allocated.
+ *
+ * Complexity:  O(1) - average case
+ *		O(n) - worst case, or to resize the table
+ */
+int insertElement (SET *set, char *elt)
+{
+  int i, locn, changed = 0;
+
+  unsigned hash;
+
+  uintptr_t slot;
+
+  TABLE *t;
+
+  RECORD *rec;
+
+  if ((rec = enterSet (set)) == NULL)
+    return 0;
+
+  hash = hashString (elt);
+
+  t = atomic_load (&set->table);
+
+  locn = hash & (t->size - 1);
+
+  for (i = 0; i < t->size; ) {
+
+    slot = atomic_load (&t->slots[locn]);
+
+    /* Case if it's unused: reserve it if the table has room, and try to claim it */
+
+    if (slot == 0) {
+
+      if (atomic_fetch_add (&t->claimed, 1) < t->size / 2) {
+
+        if (atomic_compare_exchange_strong (&t->slots[locn], &slot, (uintptr_t) elt)) {
+          changed = 1;
+          break;
+        }
+
+        atomic_fetch_sub (&t->claimed, 1);
+
+        continue; /* Another thread changed it first, so look at it again */
+      }
+
+      atomic_fetch_sub (&t->claimed, 1);
+
+      slot = MOVED; /* The table is full, so resize it as below */
+    }
+
+    /* Case if a resize has reached it: finish it and start again in the new table */
+
+    if (slot & MOVED) {
+
+      if ((t = resizeTable (set, rec, t)) == NULL)
+        break;
+
+      locn = hash & (t->size - 1);
+
+      i = 0;
+
+      continue;
+    }
+
+    /* If it holds an equal string: */
+
+    if (strcmp ((char *) (slot & ~DELETED), elt) == 0) {
+
+      if (!(slot & DELETED))
+        break;
+
+      if (atomic_compare_exchange_strong (&t->slots[locn], &slot, (uintptr_t) elt)) {
+        retireMemory (set, rec, (char *) (slot & ~DELETED));
+        changed = 1;
+        break;
+      }
+
+      continue;
+    }
+
+    locn = (locn + 1) & (t->size - 1);
+
+    i++;
+  }
+
+  if (changed)
+    atomic_fetch_add (&set->count, 1);
+
+  leaveSet (rec);
+
+  return changed;
+}
+
+/*
+ * Function:	numElements
+ *
+ * Description:	Returns the number of elements in `set`. While other threads are
+ *		inserting or deleting, this is only a snapshot.
+ *
+ * Complexity:  O(1)
+ */
+int numElements (SET *set)
+{
+  return atomic_load (&set->count);
+}
+
+/*
+ * Function:    hasElement
+ *
+ * Description: Returns if `elt` is a member of `set`. A search that reaches a slot
+ *		frozen by a resize helps to finish it, and searches the new table.
+ *
+ * Complexity:  O(1) - average case
+ *		O(n) - worst case, or to resize the table
+ */
+int hasElement (SET *set, char *elt)
+{
+  int i, locn, found = 0;
+
+  unsigned hash;
+
+  uintptr_t slot;
+
+  TABLE *t;
+
+  RECORD *rec;
+
+  if ((rec = enterSet (set)) == NULL)
+    return 0;
+
+  hash = hashString (elt);
+
+  t = atomic_load (&set->table);
+
+  locn = hash & (t->size - 1);
+
+  for (i = 0; i < t->size; ) {
+
+    slot = atomic_load (&t->slots[locn]);
+
+    if (slot == 0)
+      break;
+
+    if (slot & MOVED) {
+
+      if ((t = resizeTable (set, rec, t)) == NULL)
+        break;
+
+      locn = hash & (t->size - 1);
+
+      i = 0;
+
+      continue;
+    }
+
+    if (strcmp ((char *) (slot & ~DELETED), elt) == 0) {
+      found = !(slot & DELETED);
+      break;
+    }
+
+    locn = (locn + 1) & (t->size - 1);
+
+    i++;
+  }
+
+  leaveSet (rec);
+
+  return found;
+}
+
+/*
+ * Function:    deleteElement
+ *
+ * Description: Deletes `elt` from `set`, and returns whether the set changed. The slot
+ *		keeps its string, tagged as deleted, so that it goes on identifying
+ *		`elt` to later insertions until the next resize drops it.
+ *
+ * Complexity:  O(1) - average case
+ *		O(n) - worst case, or to resize the table
+ */
+int deleteElement (SET *set, char *elt)
+{
+  int i, locn, changed = 0;
+
+  unsigned hash;
+
+  uintptr_t slot;
+
+  TABLE *t;
+
+  RECORD *rec;
+
+  if ((rec = enterSet (set)) == NULL)
+    return 0;
+
+  hash = hashString (elt);
+
+  t = atomic_load (&set->table);
+
+  locn = hash & (t->size - 1);
+
+  for (i = 0; i < t->size; ) {
+
+    slot = atomic_load (&t->slots[locn]);
+
+    if (slot == 0)
+      break;
+
+    if (slot & MOVED) {
+
+      if ((t = resizeTable (set, rec, t)) == NULL)
+        break;
+
+      locn = hash & (t->size - 1);
+
+      i = 0;
+
+      continue;
+    }
+
+    if (strcmp ((char *) (slot & ~DELETED), elt) == 0) {
+
+      if (slot & DELETED)
+        break;
+
+      if (atomic_compare_exchange_strong (&t->slots[locn], &slot, slot | DELETED)) {
+        changed = 1;
+        break;
+      }
+
+      continue; /* The slot changed under us, so look at it again */
+    }
+
+    locn = (locn + 1) & (t->size - 1);
+
+    i++;
+  }
+
+  if (changed)
+    atomic_fetch_sub (&set->count, 1);
+
+  leaveSet (rec);
+
+  return changed;
+}
+
+/*
+ * Function:    destroySet
+ *
+ * Description: Deallocates memory associated with `set`, including every string it owns.
+ *		No other thread may be using the set.
+ *
+ * Complexity:  O(n)
+ */
+void destroySet (SET *set)
+{
+  int i;
+
+  TABLE *t;
+
+  RECORD *rec, *next;
+
+  RETIRED *r, *rnext;
+
+  t = atomic_load (&set->table);
+
+  for (i = 0; i < t->size; i++)
+    free ((char *) (atomic_load (&t->slots[i]) & ~DELETED));
+
+  for (rec = atomic_load (&set->records); rec != NULL; rec = next) {
+
+    for (r = rec->limbo; r != NULL; r = rnext) {
+      rnext = r->next;
+      free (r->ptr);
+      free (r);
+    }
+
+    next = rec->next;
+
+    free (rec);
+  }
+
+  free (t);
+
+  free (set);
+
+  return;
+}
@@ -0,0 +1,176 @@
+/*
+ * File:	main.c
+ *
+ * Description:	This file contains the main function for testing an immutable
+ *		set abstract data type for strings.
+ *
+ *		The program takes two files as command line arguments, the
+ *		second of which is optional.  All words in the first file
+ *		are read, sorted, and built into a set, and the counts of
+ *		total words and total words in the set are printed along
+ *		with the bytes the set takes.  The set is then saved to a
+ *		file and loaded back, and every word is looked up in the
+ *		loaded set.  If the second file is given then the count of
+ *		words in the first file that are not in the second file is
+ *		printed, using a set built from the second file.
+ *
+ */
+
+# include <stdio.h>
+# include <stdlib.h>
+# include <string.h>
+# include "set.h"
+
+
+/* The file the set is saved to and loaded from. */
+
+# define SET_FILE "words.fcs"
+
+
+/*
+ * Function:	compareStrings
+ *
+ * Description:	Compares the strings pointed to by `a` and `b`, for use with qsort.
+ */
+
+static int compareStrings (const void *a, const void *b)
+{
+    return strcmp (*(char **) a, *(char **) b);
+}
+
+
+/*
+ * Function:	readWords
+ *
+ * Description:	Returns an array of copies of the words in the file `fp`, and sets
+ *		`n` to their number.
+ */
+
+static char **readWords (FILE *fp, int *n)
+{
+    char buffer [BUFSIZ];
+    char **words;
+    int max;
+
+    *n = 0;
+    max = 1024;
+    words = malloc (max * sizeof (char *));
+
+    while (words != NULL && fscanf (fp, "%s", buffer) == 1) {
+	if (*n == max)
+	    words = realloc (words, (max *= 2) * sizeof (char *));
+	if (words != NULL && (words [*n] = strdup (buffer)) != NULL)
+	    (*n) ++;
+    }
+
+    return words;
+}
+
+
+/*
+ * Function:	main
+ *
+ * Description:	Driver function for the test program.
+ */
+
+int main (int argc, char *argv [])
+{
+    SET *set, *loaded;
+    FILE *fp;
+    char **words, **sorted, **removed;
+    int i, n, m, unique, count, remaining;
+
+    /* Check usage and open the first file. */
+
+    if (argc == 1 || argc > 3) {
+	fprintf (stderr, "usage: %s file1 [file2]\n", argv [0]);
+	exit (EXIT_FAILURE);
+    }
+
+    if ((fp = fopen (argv [1], "r")) == NULL) {
+	fprintf (stderr, "%s: cannot open %s\n", argv [0], argv [1]);
+	exit (EXIT_FAILURE);
+    }
+
+    words = readWords (fp, &n);
+    fclose (fp);
+
+    if (words == NULL || (sorted = malloc ((n + 1) * sizeof (char *))) == NULL) {
+	fprintf (stderr, "%s: out of memory\n", argv [0]);
+	exit (EXIT_FAILURE);
+    }
+
+
+    /* Sort the words, drop the duplicates, and build the set. */
+
+    memcpy (sorted, words, n * sizeof (char *));
+    qsort (sorted, n, sizeof (char *), compareStrings);
+
+    for (i = 0, unique = 0; i < n; i ++)
+	if (unique == 0 || strcmp (sorted [i], sorted [unique - 1]) != 0)
+	    sorted [unique ++] = sorted [i];
+
+    if ((set = buildSet (sorted, unique)) == NULL) {
+	fprintf (stderr, "%s: failed to create set\n", argv [0]);
+	exit (EXIT_FAILURE);
+    }
+
+    printf ("%d total words\n", n);
+    printf ("%d unique words\n", numElements (set));
+    printf ("%zu bytes\n", setBytes (set));
+
+
+    /* Save the set, load it back, and look up every word. */
+
+    if (!saveSet (set, SET_FILE) || (loaded = loadSet (SET_FILE)) == NULL) {
+	fprintf (stderr, "%s: cannot save and load %s\n", argv [0], SET_FILE);
+	exit (EXIT_FAILURE);
+    }
+
+    for (i = 0; i < n; i ++)
+	if (!hasElement (loaded, words [i]))
+	    fprintf (stderr, "%s missing from loaded set\n", words [i]);
+
+    destroySet (set);
+    remove (SET_FILE);
+
+
+    /* Count the words in the first file that are not in the second. */
+
+    if (argc == 3) {
+	if ((fp = fopen (argv [2], "r")) == NULL) {
+	    fprintf (stderr, "%s: cannot open %s\n", argv [0], argv [2]);
+	    exit (EXIT_FAILURE);
+	}
+
+	removed = readWords (fp, &m);
+	fclose (fp);
+
+	if (removed == NULL) {
+	    fprintf (stderr, "%s: out of memory\n", argv [0]);
+	    exit (EXIT_FAILURE);
+	}
+
+	qsort (removed, m, sizeof (char *), compareStrings);
+
+	for (i = 0, count = 0; i < m; i ++)
+	    if (count == 0 || strcmp (removed [i], removed [count - 1]) != 0)
+		removed [count ++] = removed [i];
+
+	destroySet (loaded);
+
+	if ((loaded = buildSet (removed, count)) == NULL) {
+	    fprintf (stderr, "%s: failed to create set\n", argv [0]);
+	    exit (EXIT_FAILURE);
+	}
+
+	for (i = 0, remaining = 0; i < unique; i ++)
+	    if (!hasElement (loaded, sorted [i]))
+		remaining ++;
+
+	printf ("%d remaining words\n", remaining);
+    }
+
+    destroySet (loaded);
+    exit (EXIT_SUCCESS);
+}
@@ -0,0 +1,436 @@
+/*
+ * File:	set.c
+ *
+ * Description:	This file contains the implementation for an immutable set abstract data
+ *              type. The algorithm used to implement the set is front coding: the sorted
+ *              elements are split into buckets of BUCKET strings, the first string of each
+ *              bucket is stored in full, and every other string is stored as the length
+ *              of the prefix it shares with the string before it followed by the rest of
+ *              it. Sorted words share long prefixes, so this takes far less memory than
+ *              an array of pointers to separate copies.
+ *
+ *              Determining membership is a binary search over the first strings of the
+ *              buckets followed by a scan through one bucket. The scan never rebuilds a
+ *              string: it only tracks how much of the element sought matches the string
+ *              decoded so far, which is enough to compare it with the next one.
+ *
+ *              The whole set is one block of memory laid out exactly as in its file:
+ *
+ *                  header   the magic string, then the number of elements, of buckets
+ *                           and of bytes of string data, as native 32 bit integers
+ *                  offsets  the offset of each bucket within the string data
+ *                  data     the buckets, each a NUL terminated first string followed by
+ *                           its other strings, each a varint shared prefix length and a
+ *                           NUL terminated suffix
+ *
+ *              So loading a saved set only maps its file into memory, with no parsing.
+ *              Files are only readable on machines with the byte order that wrote them.
+ *
+ *              A set is an unordered collection of unique elements. Each element is a string.
+ *
+ */
+
+# include <stdio.h>
+# include <stdlib.h>
+# include <string.h>
+# include <fcntl.h>
+# include <unistd.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include "set.h"
+
+# define BUCKET 16 /* The number of strings in a bucket */
+# define MAGIC "FCSET01" /* Identifies a set file, including the terminating NUL */
+# define HEADER 20 /* The size of the header: the magic string and three integers */
+
+/* Definition of the `set` data type */
+struct set
+{
+  int count; /* The number of elements */
+
+  int buckets; /* The number of buckets */
+
+  unsigned *offsets; /* The offset of each bucket in `data` */
+
+  char *data; /* The buckets of strings */
+
+  char *image; /* The block holding the header, offsets and data */
+
+  size_t length; /* The size of `image` in bytes */
+
+  int mapped; /* Whether `image` is a mapped file rather than allocated memory */
+};
+
+/* Private function prototypes */
+static int sharedPrefix (char *a, char *b);
+static char *readLength (char *p, int *length);
+static int attachImage (SET *set);
+static int locateBucket (SET *set, char *elt);
+
+/*
+ * Function:	sharedPrefix
+ *
+ * Description: Returns the length of the longest common prefix of `a` and `b`.
+ *
+ * Complexity:  O(m), where m is the length of the prefix
+ */
+static int sharedPrefix (char *a, char *b)
+{
+  int i = 0;
+
+  while (a[i] != '\0' && a[i] == b[i])
+    i++;
+
+  return i;
+}
+
+/*
+ * Function:	readLength
+ *
+ * Description: Decodes the varint at `p`, seven bits per byte with the high bit set on all
+ *		but the last byte, into `length`, and returns the address following it.
+ *
+ * Complexity:  O(1)
+ */
+static char *readLength (char *p, int *length)
+{
+  int shift = 0;
+
+  *length = 0;
+
+  do {
+    *length |= (*p & 0x7f) << shift;
+    shift += 7;
+  } while (*p++ & 0x80);
+
+  return p;
+}
+
+/*
+ * Function:	attachImage
+ *
+ * Description: Sets the fields of `set` from the header of its image, and returns whether
+ *		the image is a well formed set.
+ *
+ * Complexity:  O(1)
+ */
+static int attachImage (SET *set)
+{
+  unsigned header[3];
+
+  if (set->length < HEADER || memcmp (set->image, MAGIC, sizeof(MAGIC)) != 0)
+    return 0;
+
+  memcpy (header, set->image + sizeof(MAGIC), sizeof(header));
+
+  if (HEADER + (size_t) header[1] * sizeof(unsigned) + header[2] != set->length)
+    return 0;
+
+  if ((header[1] == 0) != (header[0] == 0))
+    return 0;
+
+  set->count = header[0];
+
+  set->buckets = header[1];
+
+  set->offsets = (unsigned *) (set->image + HEADER);
+
+  set->data = set->image + HEADER + header[1] * sizeof(unsigned);
+
+  return 1;
+}
+
+/*
+ * Function:	buildSet
+ *
+ * Description: Creates and returns a set of the `n` strings in `elts`, which must be sorted
+ *		in increasing order without duplicates, as sortElements returns them. The
+ *		strings are copied, so the array and strings can be released afterwards.
+ *		Returns NULL if the strings are out of order or memory runs out.
+ *
+ * Complexity:  O(m), where m is the total length of the strings
+ */
+SET *buildSet (char **elts, int n)
+{
+  SET *set;
+
+  size_t bytes = 0;
+
+  unsigned header[3], *offsets;
+
+  int i, shared, length;
+
+  char *p;
+
+  /* Check the order and size the string data. */
+
+  for (i = 0; i < n; i++) {
+
+    if (i > 0 && strcmp (elts[i - 1], elts[i]) >= 0)
+      return NULL;
+
+    shared = i % BUCKET == 0 ? 0 : sharedPrefix (elts[i - 1], elts[i]);
+
+    for (length = shared; length >= 0x80; length >>= 7)
+      bytes++;
+
+    bytes += (i % BUCKET == 0 ? 0 : 1) + strlen (elts[i] + shared) + 1;
+  }
+
+  if ((set = malloc (sizeof(SET))) == NULL)
+    return NULL;
+
+  header[0] = n;
+
+  header[1] = (n + BUCKET - 1) / BUCKET;
+
+  header[2] = bytes;
+
+  set->length = HEADER + header[1] * sizeof(unsigned) + bytes;
+
+  set->mapped = 0;
+
+  if ((set->image = malloc (set->length)) == NULL) {
+    free (set);
+    return NULL;
+  }
+
+  memcpy (set->image, MAGIC, sizeof(MAGIC));
+
+  memcpy (set->image + sizeof(MAGIC), header, sizeof(header));
+
+  attachImage (set);
+
+  /* Write the buckets. */
+
+  offsets = set->offsets;
+
+  p = set->data;
+
+  for (i = 0; i < n; i++) {
+
+    if (i % BUCKET == 0) {
+      offsets[i / BUCKET] = p - set->data;
+      shared = 0;
+    }
+
+    else {
+
+      shared = sharedPrefix (elts[i - 1], elts[i]);
+
+      for (length = shared; length >= 0x80; length >>= 7)
+	*p++ = (length & 0x7f) | 0x80;
+
+      *p++ = length;
+    }
+
+    strcpy (p, elts[i] + shared);
+
+    p += strlen (p) + 1;
+  }
+
+  return set;
+}
+
+/*
+ * Function:	loadSet
+ *
+ * Description: Returns the set saved in the file `path`, mapped into memory rather than
+ *		read, or NULL if the file cannot be mapped or does not hold a set.
+ *
+ * Complexity:  O(1) - the pages of the file are read as they are touched
+ */
+SET *loadSet (char *path)
+{
+  SET *set;
+
+  struct stat st;
+
+  int fd;
+
+  if ((set = malloc (sizeof(SET))) == NULL)
+    return NULL;
+
+  if ((fd = open (path, O_RDONLY)) < 0) {
+    free (set);
+    return NULL;
+  }
+
+  if (fstat (fd, &st) < 0 || st.st_size < HEADER) {
+    close (fd);
+    free (set);
+    return NULL;
+  }
+
+  set->length = st.st_size;
+
+  set->mapped = 1;
+
+  set->image = mmap (NULL, set->length, PROT_READ, MAP_PRIVATE, fd, 0);
+
+  close (fd);
+
+  if (set->image == MAP_FAILED) {
+    free (set);
+    return NULL;
+  }
+
+  if (!attachImage (set)) {
+    munmap (set->image, set->length);
+    free (set);
+    return NULL;
+  }
+
+  return set;
+}
+
+/*
+ * Function:	saveSet
+ *
+ * Description: Writes `set` to the file `path`, and returns whether it succeeded.
+ *
+ * Complexity:  O(n)
+ */
+int saveSet (SET *set, char *path)
+{
+  FILE *fp;
+
+  int ok;
+
+  if ((fp = fopen (path, "wb")) == NULL)
+    return 0;
+
+  ok = fwrite (set->image, 1, set->length, fp) == set->length;
+
+  return fclose (fp) == 0 && ok;
+}
+
+/*
+ * Function:	destroySet
+ *
+ * Description: Deallocates memory associated with `set`, or unmaps its file.
+ *
+ * Complexity:  O(1)
+ */
+void destroySet (SET *set)
+{
+  if (set->mapped)
+    munmap (set->image, set->length);
+  else
+    free (set->image);
+
+  free (set);
+}
+
+/*
+ * Function:	numElements
+ *
+ * Description:	Returns the number of elements in `set`.
+ *
+ * Complexity:  O(1)
+ */
+int numElements (SET *set)
+{
+  return set->count;
+}
+
+/*
+ * Function:	setBytes
+ *
+ * Description:	Returns the number of bytes taken by the elements of `set`, which is also
+ *		the size of its file.
+ *
+ * Complexity:  O(1)
+ */
+size_t setBytes (SET *set)
+{
+  return set->length;
+}
+
+/*
+ * Function:	locateBucket
+ *
+ * Description: Returns the last bucket of `set` whose first string is not greater than
+ *		`elt`, or -1 if there is none.
+ *
+ * Complexity:  O(logn)
+ */
+static int locateBucket (SET *set, char *elt)
+{
+  int low, mid, high;
+
+  low = 0;
+
+  high = set->buckets - 1;
+
+  while (low <= high) {
+
+    mid = (low + high) / 2;
+
+    if (strcmp (set->data + set->offsets[mid], elt) <= 0)
+      low = mid + 1;
+    else
+      high = mid - 1;
+  }
+
+  return high;
+}
+
+/*
+ * Function:	hasElement
+ *
+ * Description: Returns whether `elt` is a member of `set`. Within the bucket, `match` is
+ *		the length of the prefix that `elt` shares with the string last decoded,
+ *		which is smaller than `elt`. If the next string shares more than that with
+ *		the last one, it is smaller than `elt` too; if it shares less, it is larger,
+ *		and so is every string after it; only if it shares exactly that much do its
+ *		remaining characters need to be compared.
+ *
+ * Complexity:  O(logn)
+ */
+int hasElement (SET *set, char *elt)
+{
+  int i, b, shared, match, last;
+
+  char *p;
+
+  if ((b = locateBucket (set, elt)) < 0)
+    return 0;
+
+  p = set->data + set->offsets[b];
+
+  match = sharedPrefix (p, elt);
+
+  if (p[match] == elt[match])
+    return 1;
+
+  p += strlen (p) + 1;
+
+  last = b == set->buckets - 1 ? set->count - b * BUCKET : BUCKET;
+
+  for (i = 1; i < last; i++) {
+
+    p = readLength (p, &shared);
+
+    if (shared < match)
+      return 0;
+
+    if (shared == match) {
+
+      while (*p != '\0' && *p == elt[match]) {
+	p++;
+	match++;
+      }
+
+      if (*p == elt[match])
+	return 1;
+
+      if ((unsigned char) *p > (unsigned char) elt[match])
+	return 0;
+    }
+
+    p += strlen (p) + 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,29 @@
+/*
+ * File:	set.h
+ *
+ * Description:	This file contains the specification of the structure and function prototypes
+ *              for an immutable set abstract data type.
+ *
+ *              A set is an unordered collection of unique elements. Each element is a string.
+ *              This set is built once from a sorted array of strings, such as the output of
+ *              sortElements, and can be saved to a file and loaded back.
+ *
+ */
+
+# include <stddef.h>
+
+typedef struct set SET;
+
+SET *buildSet (char **elts, int n);
+
+SET *loadSet (char *path);
+
+int saveSet (SET *set, char *path);
+
+void destroySet (SET *set);
+
+int numElements (SET *set);
+
+int hasElement (SET *set, char *elt);
+
+size_t setBytes (SET *set);
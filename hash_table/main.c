@@ -9,7 +9,9 @@
  *		are inserted into the set and the counts of total words and
  *		total words in the set are printed.  If the second file is
  *		given then all words in the second file are deleted from the
- *		set and the count printed.
+ *		set and the count printed, followed by the fraction of the
+ *		table's slots left holding deleted markers and the maximum
+ *		and mean probe lengths of the set.
  *
  * Author:      Brian Jenkins (bj@jenkinz.com)
  * Date:        05/05/2012
@@ -22,7 +24,7 @@
 # include "set.h"
 
 
-/* The maximum size of the set. */
+/* The initial size of the set. */
 
 # define MAX_SIZE 15000
 
@@ -82,6 +84,9 @@ int main (int argc, char *argv [])
             deleteElement (set, buffer);
 
         printf ("%d remaining words\n", numElements (set));
+        printf ("%.2f tombstone ratio\n", tombstoneRatio (set));
+        printf ("%d max probe length\n", maxProbeLength (set));
+        printf ("%.2f mean probe length\n", meanProbeLength (set));
     }
 
     destroySet (set);
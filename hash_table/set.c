@@ -4,10 +4,28 @@
  * Description:	This file contains the implementation for a set abstract data type.
  *              The algorithm used to implement the set is a hash table with linear
  *              probing to resolve collisions. The hash function used has time
- *              relative to the size of the input array. Determining membership,
- *              insertion and deletion have constant time for the average case when
- *              all keys map to different locations, and linear time for the worst
- *              case when linear probing is required for each key.
+ *              relative to the size of the input array, and the table size is kept
+ *              a power of two so that the index is the hash masked to the table
+ *              size. Determining membership, insertion and deletion have constant
+ *              time for the average case when all keys map to different locations,
+ *              and linear time for the worst case when linear probing is required
+ *              for each key.
+ *
+ *              The table grows once it passes its maximum load. Rather than rehashing
+ *              every element at once, the old array is kept alongside the new one and
+ *              each operation moves a few of its slots over, so no single insertion
+ *              pays for the whole resize. Lookups consult both arrays meanwhile.
+ *
+ *              Deleting an element leaves a deleted marker in its slot, which searches
+ *              must probe past. The markers are counted, and once too many build up
+ *              the table is rehashed in place: every element is moved to the first
+ *              free slot of its probe sequence and the markers are cleared, without
+ *              allocating a second array.
+ *
+ *              The full hash code of every element is kept in an array parallel to the
+ *              element strings. Probing compares those integers first and only reads an
+ *              element string when the codes are equal, and a resize places elements by
+ *              their stored codes without reading the strings at all.
  *
  *              A set is an unordered collection of unique elements. Each element is a string.
  *
@@ -20,159 +38,582 @@
 # include <stdlib.h>
 # include <string.h>
 # include "set.h"
+# include "../common/hash.h"
+# include "../common/prefetch.h"
+# include "../common/parallel.h"
 
 # define EMPTY 0
 # define FILLED 1
 # define DEL 2
+# define REHASH 3 /* A filled slot whose element has yet to be placed by an in-place rehash */
 
-/* Definition of the `set` data type */
-struct set
+# define MAX_LOAD 0.75 /* Fraction of FILLED or DEL slots that triggers a resize */
+# define MIGRATE_SLOTS 4 /* Number of old slots moved into the new array per operation */
+# define MIN_SIZE 8 /* The smallest array ever allocated */
+# define MAX_DELETED 0.2 /* Fraction of DEL slots that triggers an in-place rehash */
+# define BATCH 16 /* Number of keys of a batch hashed and prefetched together */
+
+/* Definition of the arrays making up one hash table */
+typedef struct table
 {
-  int count; /* The number of elements currently in `elts` */
+  int size; /* The number of slots, a power of two, or 0 if the table is not allocated */
+
+  int used; /* The number of slots that are not empty */
 
-  int size; /* The maximum size of `elts` */
+  int deleted; /* The number of deleted slots */
 
   char **elts; /* The array of element strings */
 
+  unsigned *hashes; /* The full hash code of the element in each filled slot */
+
   char *flag; /* Keeps track of whether the slot in the array is empty, full, or deleted */
+} TABLE;
+
+/* Definition of the `set` data type */
+struct set
+{
+  int count; /* The number of elements currently in the set */
+
+  TABLE cur; /* The table new elements are inserted into */
+
+  TABLE old; /* The table being drained during a resize, if its size is not 0 */
+
+  int migrated; /* The number of slots in `old` already moved into `cur` */
 };
 
+/* The state shared by the threads building a set from an array of keys */
+typedef struct build
+{
+  SET *set; /* The set being built */
+
+  char **keys; /* The array of keys */
+
+  int n; /* The number of keys */
+
+  int threads; /* The number of threads, which is also the number of table regions */
+
+  unsigned *hashes; /* The hash code of each key */
+
+  int *order; /* The indices of the keys, grouped by the region of their first slot */
+
+  int *starts; /* Where the keys of each region begin in `order` */
+
+  int *offsets; /* Where each thread places its next key of each region in `order` */
+} BUILD;
+
+/* The share of a build done by one thread */
+typedef struct job
+{
+  BUILD *b; /* The build this job is part of */
+
+  int t; /* The slice of keys this thread hashes, and the region it fills */
+
+  int count; /* The number of elements placed into the region */
+
+  int spilled; /* The number of keys that ran past the end of the region */
+} JOB;
+
 /* Private function prototypes */
-static unsigned hashIt (char *s, SET *set);
-static int locateElement (SET *set, char *elt, int *found);
+static int createTable (TABLE *t, int size);
+static void destroyTable (TABLE *t);
+static int locateElement (TABLE *t, char *elt, unsigned hash, int *found);
+static int freeSlot (TABLE *t, unsigned hash);
+static void moveElements (SET *set, int slots);
+static void rehashTable (TABLE *t);
+static int resizeSet (SET *set);
+static void prefetchSlots (SET *set, unsigned hash);
+static int insertHashed (SET *set, char *elt, unsigned hash);
+static int hasHashed (SET *set, char *elt, unsigned hash);
+static int deleteHashed (SET *set, char *elt, unsigned hash);
+static int regionOf (BUILD *b, int locn);
+static int regionStart (BUILD *b, int r);
+static void *hashKeys (void *arg);
+static void *scatterKeys (void *arg);
+static void *fillRegion (void *arg);
+
+/*
+ * Function:	createTable
+ *
+ * Description: Allocates the arrays of `t` with `size` empty slots, and returns
+ *		whether it succeeded.
+ *
+ * Complexity:  O(n)
+ */
+static int createTable (TABLE *t, int size)
+{
+  int i;
+
+  t->elts = malloc (size * sizeof(char *));
+
+  t->hashes = malloc (size * sizeof(unsigned));
+
+  t->flag = malloc (size * sizeof(char));
+
+  if (t->elts == NULL || t->hashes == NULL || t->flag == NULL) {
+    free (t->elts);
+    free (t->hashes);
+    free (t->flag);
+    return 0;
+  }
+
+  t->size = size;
+
+  t->used = 0;
+
+  t->deleted = 0;
+
+  for (i = 0; i < size; i++)
+    t->flag[i] = EMPTY;
+
+  return 1;
+}
 
 /*
- * Function:	hashIt
+ * Function:	destroyTable
  *
- * Description: Performs the hash function on the element `elt`, and returns
- *		the index in `set` where it should be inserted.
+ * Description: Deallocates the arrays of `t` and marks it unallocated.
  *
- * Complexity:  O(x) - x is the length of the `elt` string
+ * Complexity:  O(1)
  */
-static unsigned hashIt (char *elt, SET* set)
+static void destroyTable (TABLE *t)
 {
-  unsigned hash = 0;
+  free (t->flag);
+
+  free (t->hashes);
 
-  while (*elt != '\0') /* while the end of the string has not yet been reached */
-    hash = (31 * hash + *elt ++); /* revise the `hash` with the current character, and proceed to the next char */
+  free (t->elts);
 
-  return hash % set->size;
+  t->elts = NULL;
+
+  t->hashes = NULL;
+
+  t->flag = NULL;
+
+  t->size = 0;
 }
 
 /*
  * Function:	locateElement
  *
- * Description: Returns the location of an element in the `set` using the hash function.
+ * Description: Returns the location of an element in the table `t`, given its `hash`.
  *              If element present: return its index, and set `found` pointer to 1. If
- *		element not present, return the index of where it would have been, and
- *		set found pointer to 0.
+ *		element not present, return the index of where it should be inserted (the
+ *		first deleted slot on its probe sequence, otherwise the empty slot that
+ *		ended it), and set found pointer to 0. A filled slot's string is only
+ *		compared when its stored hash code equals `hash`.
  *
  * Complexity:  O(1) - average case, where all keys map to different locations
  *		O(n) - worst case, where linear probing is required for each key
  */
-static int locateElement (SET *set, char *elt, int *found)
+static int locateElement (TABLE *t, char *elt, unsigned hash, int *found)
 {
-  int first, locn, i, actual = -1, actcount = 0;
+  int first, locn, i, deleted = -1;
 
-  first = hashIt (elt, set);
+  first = hash & (t->size - 1);
 
-  for (i = 0; i < set->size; i++) {
+  for (i = 0; i < t->size; i++) {
 
-    locn = (first + i) % set->size;
+    locn = (first + i) & (t->size - 1);
 
     /* Case if it's empty: */
 
-    if (set->flag[locn] == EMPTY) {
+    if (t->flag[locn] == EMPTY) {
       *found = 0;
-      return locn;
+      return deleted != -1 ? deleted : locn;
     }
 
     /* If it's deleted: */
 
-    else if (set->flag[locn] == DEL) {
-      actual = locn;
-      actcount++;	/* We need a counter to keep track of the FIRST deleted slot encountered */
+    else if (t->flag[locn] == DEL) {
+      if (deleted == -1)
+        deleted = locn;	/* Remember the FIRST deleted slot encountered */
     }
 
     /* If it's filled: */
 
-    else if (strcmp (set->elts[locn], elt) == 0) {
+    else if (t->hashes[locn] == hash && strcmp (t->elts[locn], elt) == 0) {
       *found = 1;
       return locn;
     }
   }
 
   *found = 0;
-  return (actual - actcount);     /* Make sure we return the FIRST deleted slot encountered */
+  return deleted;
+}
+
+/*
+ * Function:	freeSlot
+ *
+ * Description: Returns the first empty or deleted slot on the probe sequence of `hash`
+ *		in the table `t`, without looking at any element.
+ *
+ * Complexity:  O(1) - average case
+ *		O(n) - worst case
+ */
+static int freeSlot (TABLE *t, unsigned hash)
+{
+  int locn;
+
+  locn = hash & (t->size - 1);
+
+  while (t->flag[locn] == FILLED)
+    locn = (locn + 1) & (t->size - 1);
+
+  return locn;
+}
+
+/*
+ * Function:	moveElements
+ *
+ * Description: Advances a resize in progress by moving up to `slots` slots of the old
+ *		table into the current one. The stored hash codes give each element's new
+ *		slot, so the element strings are never read. Moved slots are marked deleted
+ *		so that the probe sequences of the elements not yet moved stay intact. Once
+ *		every slot has been visited, the old table is released.
+ *
+ * Complexity:  O(slots) - average case
+ */
+static void moveElements (SET *set, int slots)
+{
+  int locn;
+
+  TABLE *old = &set->old, *cur = &set->cur;
+
+  while (slots-- > 0 && set->migrated < old->size) {
+
+    if (old->flag[set->migrated] == FILLED) {
+
+      locn = freeSlot (cur, old->hashes[set->migrated]);
+
+      if (cur->flag[locn] == EMPTY)
+        cur->used++;
+      else
+        cur->deleted--;
+
+      cur->elts[locn] = old->elts[set->migrated];
+
+      cur->hashes[locn] = old->hashes[set->migrated];
+
+      cur->flag[locn] = FILLED;
+
+      old->flag[set->migrated] = DEL;
+    }
+
+    set->migrated++;
+  }
+
+  if (old->size > 0 && set->migrated == old->size)
+    destroyTable (old);
+}
+
+/*
+ * Function:	rehashTable
+ *
+ * Description: Clears the deleted slots of the table `t` in place. Every filled slot is
+ *		first marked as waiting to be placed and every deleted one as empty. Then
+ *		each waiting element is moved to the first slot of its probe sequence that
+ *		holds no placed element. That slot is either the element's own, or an
+ *		empty one, or one whose element is still waiting, in which case the two
+ *		are swapped and the element swapped in is placed next. A placed element
+ *		is never moved again, so no probe sequence is broken.
+ *
+ * Complexity:  O(n) - average case
+ */
+static void rehashTable (TABLE *t)
+{
+  int i, locn;
+
+  char *elt;
+
+  unsigned hash;
+
+  for (i = 0; i < t->size; i++)
+    t->flag[i] = t->flag[i] == FILLED ? REHASH : EMPTY;
+
+  for (i = 0; i < t->size; i++) {
+
+    if (t->flag[i] != REHASH)
+      continue;
+
+    locn = freeSlot (t, t->hashes[i]);
+
+    if (locn == i)
+      t->flag[i] = FILLED;
+
+    else if (t->flag[locn] == EMPTY) {
+
+      t->elts[locn] = t->elts[i];
+
+      t->hashes[locn] = t->hashes[i];
+
+      t->flag[locn] = FILLED;
+
+      t->flag[i] = EMPTY;
+    }
+
+    else {
+
+      elt = t->elts[locn];
+
+      hash = t->hashes[locn];
+
+      t->elts[locn] = t->elts[i];
+
+      t->hashes[locn] = t->hashes[i];
+
+      t->flag[locn] = FILLED;
+
+      t->elts[i] = elt;
+
+      t->hashes[i] = hash;
+
+      i--; /* Place the element swapped into slot i */
+    }
+  }
+
+  t->used -= t->deleted;
+
+  t->deleted = 0;
+}
+
+/*
+ * Function:	resizeSet
+ *
+ * Description: Makes room in `set` once its table passes the maximum load. If most used
+ *		slots are deleted ones, the table is rehashed in place. Otherwise a resize
+ *		is started by making the current table the old one and allocating a fresh
+ *		table twice as large, into which the elements are moved a few slots at a
+ *		time by later operations. Returns 0 if the new table could not be allocated,
+ *		leaving `set` unchanged.
+ *
+ * Complexity:  O(n) - to clear the flags of the new table
+ */
+static int resizeSet (SET *set)
+{
+  TABLE t;
+
+  moveElements (set, set->old.size); /* Finish any resize still in progress */
+
+  if (set->count * 2 < set->cur.size) {
+    rehashTable (&set->cur);
+    return 1;
+  }
+
+  if (!createTable (&t, set->cur.size * 2))
+    return 0;
+
+  set->old = set->cur;
+
+  set->cur = t;
+
+  set->migrated = 0;
+
+  return 1;
 }
 
 /*
  * Function:	createSet
  *
- * Description: Initializes and returns a set with a maximum capacity of `size`.
+ * Description: Initializes and returns a set with an initial capacity of at least `size`.
+ *		The set grows as elements are inserted.
  *
  * Complexity:  O(n)
  */
 SET *createSet (int size)
 {
-  int i;
-
   SET *s;
 
+  int slots = MIN_SIZE;
+
+  while (slots < size)
+    slots *= 2;
+
   s = malloc (sizeof(SET));
 
   if ( s == NULL )
     return NULL;
 
-  s->elts = malloc (size * sizeof(char *));
-
-  if (s->elts == NULL)
+  if (!createTable (&s->cur, slots))
     return NULL;
 
-  s->flag = malloc (size * sizeof(char));
+  s->count = 0;
 
-  if (s->flag == NULL)
-    return NULL;
+  s->old.size = 0;
 
-  s->count = 0;
+  s->old.elts = NULL;
 
-  s->size = size;
+  s->old.hashes = NULL;
 
-  for (i = 0; i < size; i++)
-    s->flag[i] = EMPTY;
+  s->old.flag = NULL;
+
+  s->migrated = 0;
 
   return s;
 }
 
 /*
- * Function:	insertElement
+ * Function:	prefetchSlots
  *
- * Description: Inserts `elt` into `set`, and returns whether the set changed.
+ * Description: Starts loading the flag, hash code and element of the first slot `hash`
+ *		probes in each table of `set`, so that a later search for it does not stall.
+ *
+ * Complexity:  O(1)
+ */
+static void prefetchSlots (SET *set, unsigned hash)
+{
+  int locn;
+
+  locn = hash & (set->cur.size - 1);
+
+  PREFETCH (&set->cur.flag[locn]);
+
+  PREFETCH (&set->cur.hashes[locn]);
+
+  PREFETCH (&set->cur.elts[locn]);
+
+  if (set->old.size > 0) {
+
+    locn = hash & (set->old.size - 1);
+
+    PREFETCH (&set->old.flag[locn]);
+
+    PREFETCH (&set->old.hashes[locn]);
+
+    PREFETCH (&set->old.elts[locn]);
+  }
+}
+
+/*
+ * Function:	insertHashed
+ *
+ * Description: Inserts `elt`, whose hash code is `hash`, into `set`, and returns whether
+ *		the set changed. Once the table passes its maximum load a larger one is
+ *		started, and each call moves a bounded number of slots into it.
  *
  * Complexity:  O(1) - average case, where all keys map to different locations
  *		O(n) - worst case, where linear probing is required for each key
  */
-int insertElement (SET *set, char *elt)
+static int insertHashed (SET *set, char *elt, unsigned hash)
 {
   int locn, found;
 
-  if (set->count == set->size)
-    return 0;
+  if (set->cur.used + 1 > set->cur.size * MAX_LOAD)
+    if (!resizeSet (set))
+      return 0;
+
+  moveElements (set, MIGRATE_SLOTS);
 
-  locn = locateElement (set, elt, &found);
+  if (set->old.size > 0) {
+
+    locateElement (&set->old, elt, hash, &found);
+
+    if (found)
+      return 0;
+  }
+
+  locn = locateElement (&set->cur, elt, hash, &found);
 
   if (found)
     return 0;
 
-  set->elts[locn] = elt;
+  if (set->cur.flag[locn] == EMPTY)
+    set->cur.used++;
+  else
+    set->cur.deleted--;
+
+  set->cur.elts[locn] = elt;
 
-  set->flag[locn] = FILLED;
+  set->cur.hashes[locn] = hash;
+
+  set->cur.flag[locn] = FILLED;
 
   set->count++;
 
   return 1;
 }
 
+/*
+ * Function:	hasHashed
+ *
+ * Description: Returns if `elt`, whose hash code is `hash`, is a member of `set`.
+ *
+ * Complexity:  O(1) - average case
+ *		O(n) - worst case
+ */
+static int hasHashed (SET *set, char *elt, unsigned hash)
+{
+  int found;
+
+  moveElements (set, MIGRATE_SLOTS);
+
+  locateElement (&set->cur, elt, hash, &found);
+
+  if (!found && set->old.size > 0)
+    locateElement (&set->old, elt, hash, &found);
+
+  return found;
+}
+
+/*
+ * Function:	deleteHashed
+ *
+ * Description: Deletes `elt`, whose hash code is `hash`, from `set`, and returns whether
+ *		the set changed. Once too many slots of the current table are deleted, it
+ *		is rehashed in place.
+ *
+ * Complexity:  O(1) - average case
+ *		O(n) - worst case
+ */
+static int deleteHashed (SET *set, char *elt, unsigned hash)
+{
+  int locn, found;
+
+  moveElements (set, MIGRATE_SLOTS);
+
+  locn = locateElement (&set->cur, elt, hash, &found);
+
+  if (found) {
+
+    set->cur.flag[locn] = DEL;
+
+    set->cur.deleted++;
+
+    set->count--;
+
+    if (set->cur.deleted > set->cur.size * MAX_DELETED)
+      rehashTable (&set->cur);
+
+    return 1;
+  }
+
+  if (set->old.size == 0)
+    return 0;
+
+  locn = locateElement (&set->old, elt, hash, &found);
+
+  if (!found)
+    return 0;
+
+  set->old.flag[locn] = DEL;
+
+  set->count--;
+
+  return 1;
+}
+
+/*
+ * Function:	insertElement
+ *
+ * Description: Inserts `elt` into `set`, and returns whether the set changed.
+ *
+ * Complexity:  O(1) - average case, where all keys map to different locations
+ *		O(n) - worst case, where linear probing is required for each key
+ */
+int insertElement (SET *set, char *elt)
+{
+  return insertHashed (set, elt, hashString (elt));
+}
+
 /*
  * Function:	numElements
  *
@@ -194,11 +635,7 @@ int numElements (SET *set)
  */
 int hasElement (SET *set, char *elt)
 {
-  int locn, found;
-
-  locn = locateElement (set, elt, &found);
-
-  return found;
+  return hasHashed (set, elt, hashString (elt));
 }
 
 /*
@@ -211,19 +648,410 @@ int hasElement (SET *set, char *elt)
  */
 int deleteElement (SET *set, char *elt)
 {
+  return deleteHashed (set, elt, hashString (elt));
+}
 
-  int locn, found;
+/*
+ * Function:    insertElements
+ *
+ * Description: Inserts the `n` strings in `elts` into `set`, and returns how many were
+ *		inserted. The strings are hashed BATCH at a time, and the slots of a
+ *		whole group are prefetched before any of them is searched, so that the
+ *		cache misses of the group overlap instead of following one another.
+ *
+ * Complexity:  O(n) - average case
+ */
+int insertElements (SET *set, char **elts, int n)
+{
+  int i, j, m, count = 0;
 
-  locn = locateElement (set, elt, &found);
+  unsigned hashes[BATCH];
 
-  if (!found)
+  for (i = 0; i < n; i += BATCH) {
+
+    m = n - i < BATCH ? n - i : BATCH;
+
+    for (j = 0; j < m; j++) {
+      hashes[j] = hashString (elts[i + j]);
+      prefetchSlots (set, hashes[j]);
+    }
+
+    for (j = 0; j < m; j++)
+      count += insertHashed (set, elts[i + j], hashes[j]);
+  }
+
+  return count;
+}
+
+/*
+ * Function:    hasElements
+ *
+ * Description: Sets `found[i]` to whether `elts[i]` is a member of `set`, for each of the
+ *		`n` strings in `elts`, and returns how many are members. The strings are
+ *		hashed and their slots prefetched BATCH at a time.
+ *
+ * Complexity:  O(n) - average case
+ */
+int hasElements (SET *set, char **elts, int n, int *found)
+{
+  int i, j, m, count = 0;
+
+  unsigned hashes[BATCH];
+
+  for (i = 0; i < n; i += BATCH) {
+
+    m = n - i < BATCH ? n - i : BATCH;
+
+    for (j = 0; j < m; j++) {
+      hashes[j] = hashString (elts[i + j]);
+      prefetchSlots (set, hashes[j]);
+    }
+
+    for (j = 0; j < m; j++)
+      count += found[i + j] = hasHashed (set, elts[i + j], hashes[j]);
+  }
+
+  return count;
+}
+
+/*
+ * Function:    deleteElements
+ *
+ * Description: Deletes the `n` strings in `elts` from `set`, and returns how many were
+ *		deleted. The strings are hashed and their slots prefetched BATCH at a time.
+ *
+ * Complexity:  O(n) - average case
+ */
+int deleteElements (SET *set, char **elts, int n)
+{
+  int i, j, m, count = 0;
+
+  unsigned hashes[BATCH];
+
+  for (i = 0; i < n; i += BATCH) {
+
+    m = n - i < BATCH ? n - i : BATCH;
+
+    for (j = 0; j < m; j++) {
+      hashes[j] = hashString (elts[i + j]);
+      prefetchSlots (set, hashes[j]);
+    }
+
+    for (j = 0; j < m; j++)
+      count += deleteHashed (set, elts[i + j], hashes[j]);
+  }
+
+  return count;
+}
+
+/*
+ * Function:    tombstoneRatio
+ *
+ * Description: Returns the fraction of the slots of the current table of `set` that hold
+ *		deleted markers.
+ *
+ * Complexity:  O(1)
+ */
+double tombstoneRatio (SET *set)
+{
+  return (double) set->cur.deleted / set->cur.size;
+}
+
+/*
+ * Function:    maxProbeLength
+ *
+ * Description: Returns the largest probe length of any element in `set`, that is, how
+ *		many slots past the one it hashed to the furthest element is stored.
+ *
+ * Complexity:  O(n)
+ */
+int maxProbeLength (SET *set)
+{
+  int i, dist, max = 0;
+
+  for (i = 0; i < set->cur.size; i++)
+    if (set->cur.flag[i] == FILLED) {
+      dist = (i - set->cur.hashes[i]) & (set->cur.size - 1);
+      if (dist > max)
+        max = dist;
+    }
+
+  for (i = 0; i < set->old.size; i++)
+    if (set->old.flag[i] == FILLED) {
+      dist = (i - set->old.hashes[i]) & (set->old.size - 1);
+      if (dist > max)
+        max = dist;
+    }
+
+  return max;
+}
+
+/*
+ * Function:    meanProbeLength
+ *
+ * Description: Returns the average probe length of the elements in `set`.
+ *
+ * Complexity:  O(n)
+ */
+double meanProbeLength (SET *set)
+{
+  int i;
+
+  double total = 0;
+
+  if (set->count == 0)
     return 0;
 
-  set->flag[locn] = DEL;
+  for (i = 0; i < set->cur.size; i++)
+    if (set->cur.flag[i] == FILLED)
+      total += (i - set->cur.hashes[i]) & (set->cur.size - 1);
 
-  set->count--;
+  for (i = 0; i < set->old.size; i++)
+    if (set->old.flag[i] == FILLED)
+      total += (i - set->old.hashes[i]) & (set->old.size - 1);
 
-  return 1;
+  return total / set->count;
+}
+
+/*
+ * Function:	regionOf
+ *
+ * Description: Returns the region of the table of a build that slot `locn` lies in. The
+ *		table is split into one run of consecutive slots per thread.
+ *
+ * Complexity:  O(1)
+ */
+static int regionOf (BUILD *b, int locn)
+{
+  return (unsigned long long) locn * b->threads / b->set->cur.size;
+}
+
+/*
+ * Function:	regionStart
+ *
+ * Description: Returns the first slot of region `r` of the table of a build, or the size
+ *		of the table if `r` is the number of regions.
+ *
+ * Complexity:  O(1)
+ */
+static int regionStart (BUILD *b, int r)
+{
+  return ((unsigned long long) r * b->set->cur.size + b->threads - 1) / b->threads;
+}
+
+/*
+ * Function:	hashKeys
+ *
+ * Description: Hashes the keys in the slice of the job's thread, and counts how many of
+ *		them start probing in each region.
+ *
+ * Complexity:  O(n / threads)
+ */
+static void *hashKeys (void *arg)
+{
+  JOB *job = arg;
+
+  BUILD *b = job->b;
+
+  int i, lo, hi, *counts = &b->offsets[job->t * b->threads];
+
+  lo = (long long) b->n * job->t / b->threads;
+
+  hi = (long long) b->n * (job->t + 1) / b->threads;
+
+  for (i = lo; i < hi; i++) {
+    b->hashes[i] = hashString (b->keys[i]);
+    counts[regionOf (b, b->hashes[i] & (b->set->cur.size - 1))]++;
+  }
+
+  return NULL;
+}
+
+/*
+ * Function:	scatterKeys
+ *
+ * Description: Places the indices of the keys in the slice of the job's thread into the
+ *		part of `order` belonging to the region of each.
+ *
+ * Complexity:  O(n / threads)
+ */
+static void *scatterKeys (void *arg)
+{
+  JOB *job = arg;
+
+  BUILD *b = job->b;
+
+  int i, lo, hi, *offsets = &b->offsets[job->t * b->threads];
+
+  lo = (long long) b->n * job->t / b->threads;
+
+  hi = (long long) b->n * (job->t + 1) / b->threads;
+
+  for (i = lo; i < hi; i++)
+    b->order[offsets[regionOf (b, b->hashes[i] & (b->set->cur.size - 1))]++] = i;
+
+  return NULL;
+}
+
+/*
+ * Function:	fillRegion
+ *
+ * Description: Inserts the keys that start probing in the region of the job's thread,
+ *		probing only within the region so that no other thread touches the same
+ *		slots. Since equal keys probe the same slots, duplicates meet here and only
+ *		the first is kept. A key that finds no free slot before the end of the
+ *		region is moved to the front of the region's part of `order`, to be
+ *		inserted once all threads are done.
+ *
+ * Complexity:  O(n / threads) - average case
+ */
+static void *fillRegion (void *arg)
+{
+  JOB *job = arg;
+
+  BUILD *b = job->b;
+
+  TABLE *t = &b->set->cur;
+
+  int i, k, locn, end;
+
+  end = regionStart (b, job->t + 1);
+
+  for (i = b->starts[job->t]; i < b->starts[job->t + 1]; i++) {
+
+    k = b->order[i];
+
+    locn = b->hashes[k] & (t->size - 1);
+
+    while (locn < end && t->flag[locn] == FILLED &&
+	   (t->hashes[locn] != b->hashes[k] || strcmp (t->elts[locn], b->keys[k]) != 0))
+      locn++;
+
+    if (locn == end)
+      b->order[b->starts[job->t] + job->spilled++] = k;
+
+    else if (t->flag[locn] == EMPTY) {
+
+      t->elts[locn] = b->keys[k];
+
+      t->hashes[locn] = b->hashes[k];
+
+      t->flag[locn] = FILLED;
+
+      job->count++;
+    }
+  }
+
+  return NULL;
+}
+
+/*
+ * Function:	createSetFromArray
+ *
+ * Description: Creates and returns a set holding the `n` strings in `keys`, built by
+ *		`threads` threads. The table is sized for all the keys and split into one
+ *		region of consecutive slots per thread. The threads first hash their
+ *		slices of the keys and sort them by the region they start probing in,
+ *		then each thread inserts the keys of its own region without any locking.
+ *		The few keys whose probes run past the end of their region are inserted
+ *		afterwards by the calling thread. Duplicate keys are inserted once. The
+ *		set grows as further elements are inserted, like one from createSet.
+ *
+ * Complexity:  O(n / threads) - average case, plus O(threads^2)
+ */
+SET *createSetFromArray (char **keys, int n, int threads)
+{
+  SET *set;
+
+  BUILD b;
+
+  JOB *jobs;
+
+  int i, r, t, count, slots = MIN_SIZE;
+
+  while (slots * MAX_LOAD < n)
+    slots *= 2;
+
+  if ((set = createSet (slots)) == NULL)
+    return NULL;
+
+  if (threads < 1)
+    threads = 1;
+
+  b.set = set;
+
+  b.keys = keys;
+
+  b.n = n;
+
+  b.threads = threads;
+
+  b.hashes = malloc (n * sizeof(unsigned));
+
+  b.order = malloc (n * sizeof(int));
+
+  b.starts = malloc ((threads + 1) * sizeof(int));
+
+  b.offsets = calloc (threads * threads, sizeof(int));
+
+  jobs = calloc (threads, sizeof(JOB));
+
+  if (b.hashes == NULL || b.order == NULL || b.starts == NULL || b.offsets == NULL || jobs == NULL) {
+    free (b.hashes);
+    free (b.order);
+    free (b.starts);
+    free (b.offsets);
+    free (jobs);
+    destroySet (set);
+    return NULL;
+  }
+
+  for (t = 0; t < threads; t++) {
+    jobs[t].b = &b;
+    jobs[t].t = t;
+  }
+
+  runParallel (hashKeys, jobs, sizeof(JOB), threads);
+
+  /* Turn the counts of each thread's keys per region into their offsets in `order`. */
+
+  b.starts[0] = 0;
+
+  for (r = 0, i = 0; r < threads; r++) {
+
+    for (t = 0; t < threads; t++) {
+      count = b.offsets[t * threads + r];
+      b.offsets[t * threads + r] = i;
+      i += count;
+    }
+
+    b.starts[r + 1] = i;
+  }
+
+  runParallel (scatterKeys, jobs, sizeof(JOB), threads);
+
+  runParallel (fillRegion, jobs, sizeof(JOB), threads);
+
+  for (t = 0; t < threads; t++) {
+    set->count += jobs[t].count;
+    set->cur.used += jobs[t].count;
+  }
+
+  for (t = 0; t < threads; t++)
+    for (i = b.starts[t]; i < b.starts[t] + jobs[t].spilled; i++)
+      insertHashed (set, keys[b.order[i]], b.hashes[b.order[i]]);
+
+  free (b.hashes);
+
+  free (b.order);
+
+  free (b.starts);
+
+  free (b.offsets);
+
+  free (jobs);
+
+  return set;
 }
 
 /*
@@ -235,9 +1063,9 @@ int deleteElement (SET *set, char *elt)
  */
 void destroySet (SET *set)
 {
-  free (set->flag);
+  destroyTable (&set->old);
 
-  free (set->elts);
+  destroyTable (&set->cur);
 
   free (set);
 
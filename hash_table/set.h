@@ -24,3 +24,17 @@ int hasElement (SET *set, char *elt);
 int insertElement (SET *set, char *elt);
 
 int deleteElement (SET *set, char *elt);
+
+int hasElements (SET *set, char **elts, int n, int *found);
+
+int insertElements (SET *set, char **elts, int n);
+
+int deleteElements (SET *set, char **elts, int n);
+
+double tombstoneRatio (SET *set);
+
+int maxProbeLength (SET *set);
+
+double meanProbeLength (SET *set);
+
+SET *createSetFromArray (char **keys, int n, int threads);
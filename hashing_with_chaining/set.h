@@ -25,3 +25,10 @@ int insertElement (SET *set, char *elt);
 
 int deleteElement (SET *set, char *elt);
 
+int hasElements (SET *set, char **elts, int n, int *found);
+
+int insertElements (SET *set, char **elts, int n);
+
+int deleteElements (SET *set, char **elts, int n);
+
+SET *createSetFromArray (char **keys, int n, int threads);
@@ -9,12 +9,16 @@
  *
  *		This implementation utilizes a singly linked list model, where
  *		traversal, insertion, and deletion are all linear time.
+ *
+ *		Nodes come from a pool of slabs owned by the list (see ../common/pool.h),
+ *		so deleted nodes are reused and destroying the list frees whole slabs.
  */
 
 # include <stdio.h>
 # include <stdlib.h>
 # include <string.h>
 # include "list.h"
+# include "../common/pool.h"
 
 
 /*Definition of "set" datatype: */
@@ -32,6 +36,8 @@ struct list {
 	int count;
 
 	struct node *head;
+
+	POOL pool;	//The nodes, including the head
 };
 
 /*FUNCTION:	getItems
@@ -122,9 +128,14 @@ LIST *createList (void) {
 
 		return NULL;
 
-	if ((list->head = malloc (sizeof(NODE))) == NULL)
+	initPool (&list->pool, sizeof(NODE));
+
+	if ((list->head = allocFromPool (&list->pool)) == NULL) {
+
+		free (list);
 
 		return NULL;
+	}
 
 	list->count = 0;
 
@@ -138,27 +149,16 @@ LIST *createList (void) {
 
 /*FUNCTION: 	destroyList
  *
- *DESCRIPTION:	Deallocates memory associated with "list"
+ *DESCRIPTION:	Deallocates memory associated with "list", releasing the pool of its nodes
+ *		a slab at a time
  *
- *COMPLEXITY:	O(n)
+ *COMPLEXITY:	O(n/POOL_LIMIT)
  *
  */
 
 void destroyList (LIST *list) {
 
-	NODE *pre, *loc;
-
-	pre = list->head;
-
-	do {
-
-		loc = pre->next;
-
-		free (pre);
-
-		pre = loc;
-	
-	} while (loc != NULL);
+	releasePool (&list->pool);
 
 	free (list);
 }
@@ -178,7 +178,7 @@ int insertItem (LIST *list, char *item) {
 
 	NODE *pre, *new;
 
-	if ((new = malloc (sizeof(NODE))) == NULL)
+	if ((new = allocFromPool (&list->pool)) == NULL)
 
 		return 0;
 
@@ -220,6 +220,8 @@ int deleteItem (LIST *list, char *item) {
 
 	pre->next = loc->next;
 
+	returnToPool (&list->pool, loc);
+
 	list->count--;
 
 	return 1;
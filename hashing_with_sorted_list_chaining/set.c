@@ -12,6 +12,9 @@
  *		and to resolve collisions. To do this, it uses a list ADT for each "chain"
  *		of the hash table. Therefore, insertion and deletion are linear time.
  *
+ *		The number of chains is a power of two, and the chain of an element is
+ *		picked by masking the hash from ../common/hash.h.
+ *
  *		In addition, a sorting feature has been added.  Utilizing a merge sort algorithm,
  *		it returns an array of all elements in the set in sorted order in O(nlogn) time.
  *
@@ -22,8 +25,12 @@
 # include <string.h>
 # include "list.h"
 # include "set.h"
+# include "../common/hash.h"
+# include "../common/prefetch.h"
+# include "../common/parallel.h"
 
 # define ALPHA 10
+# define BATCH 16		//Number of strings of a batch hashed and prefetched together.
 
 char **sortElements (SET *set);
 static void mergeSort (char **elements, char **temp, int lo, int hi);
@@ -36,11 +43,45 @@ struct set {
 
 	int count;		//Number of inserted elements.
 
-	int size;		//Number of slots able to hold a list.
+	int size;		//Number of slots able to hold a list, a power of two.
 
 	LIST **lists;		//To be utilized for hashing with chaining
 };
 
+
+/*Definition of the state shared by the threads building a set from an array: */
+
+typedef struct build {
+
+	SET *set;		//The set being built.
+
+	char **keys;		//The array of keys, and its length.
+
+	int n;
+
+	int threads;		//Number of threads, which is also the number of ranges of chains.
+
+	unsigned *hashes;	//Hash of each key.
+
+	int *order;		//Indices of the keys, grouped by the range of their chain.
+
+	int *starts;		//Where the keys of each range begin in "order".
+
+	int *offsets;		//Where each thread places its next key of each range in "order".
+} BUILD;
+
+
+/*Definition of the share of a build done by one thread: */
+
+typedef struct job {
+
+	BUILD *b;
+
+	int t;			//The slice of keys this thread hashes, and the range of chains it fills.
+
+	int count;		//Number of elements inserted into the range.
+} JOB;
+
 /*Function:	sortElements
  *
  *Description:	Preps all elements for sorting by placing all of them into one large dynamically
@@ -155,28 +196,6 @@ static void merge (char **elements, char **temp, int lo1, int hi1, int lo2, int
 }
 
 
-/* Function: 	hashString
- *
- * Description: Performs the given hash function on the element to be inserted, and returns
- *		the result of the hash function so that the calling function can perform 
- *		modulo division, and thus yield the proper index.
- *
- * Complexity: 	O(k), where k is the length of S
- *
- */
-
-static unsigned hashString  (char *s) {
-
-	unsigned hash = 0;
-
-	while (*s != '\0') 
-	
-		hash = (31 * hash + *s ++);
-
-	return hash;
-}
-
-
 /*FUNCTION:	createSet
  *
  *DESCRIPTION:	Creates, initializes, and returns a set with a maximum capacity of "size"
@@ -195,7 +214,8 @@ SET *createSet (int size) {
 
 		return NULL;
 
-	set->size = (size + ALPHA - 1) / ALPHA;		//Set initial size to input parameter.
+	for (set->size = 1; set->size < (size + ALPHA - 1) / ALPHA; set->size *= 2)
+		;					//Round size/ALPHA up to a power of two.
 
 	if ((set->lists = malloc(set->size * sizeof(LIST*))) == NULL)
 
@@ -258,7 +278,7 @@ int numElements (SET *set) {
 
 int hasElement (SET *set, char *elt) {
 
-	return hasItem (set->lists[(hashString (elt)) % (set->size)], elt);
+	return hasItem (set->lists[hashString (elt) & (set->size - 1)], elt);
 }
 
 
@@ -274,7 +294,7 @@ int insertElement (SET *set, char *elt) {
 
 	int found, inserted;
 
-	found = hasItem (set->lists[(hashString (elt)) % (set->size)], elt);
+	found = hasItem (set->lists[hashString (elt) & (set->size - 1)], elt);
 
 	if (found)
 
@@ -282,7 +302,7 @@ int insertElement (SET *set, char *elt) {
 
 	else {
 
-		inserted = insertItem (set->lists[(hashString (elt)) % (set->size)], elt);
+		inserted = insertItem (set->lists[hashString (elt) & (set->size - 1)], elt);
 
 		if (inserted) {
 
@@ -306,7 +326,7 @@ int insertElement (SET *set, char *elt) {
 
 int deleteElement (SET *set, char *elt) {
 
-	int deleted = deleteItem (set->lists[hashString (elt) % set->size], elt);
+	int deleted = deleteItem (set->lists[hashString (elt) & (set->size - 1)], elt);
 
 	if (!deleted)
 
@@ -317,3 +337,340 @@ int deleteElement (SET *set, char *elt) {
 	return 1;
 }
 
+
+/*FUNCTION:	findChains
+ *
+ *DESCRIPTION:	Stores in "chains" the chain of each of the "m" strings in "elts", at most BATCH.
+ *		The strings are all hashed first and the chains prefetched, first the slot of
+ *		"lists" and then the list itself, so that the cache misses overlap.
+ *
+ *COMPLEXITY:	O(m)
+ */
+
+static void findChains (SET *set, char **elts, int m, LIST **chains) {
+
+	int j;
+
+	unsigned index[BATCH];
+
+	for (j = 0; j < m; j++) {
+
+		index[j] = hashString (elts[j]) & (set->size - 1);
+
+		PREFETCH (&set->lists[index[j]]);
+	}
+
+	for (j = 0; j < m; j++) {
+
+		chains[j] = set->lists[index[j]];
+
+		PREFETCH (chains[j]);
+	}
+}
+
+
+/*FUNCTION:	hasElements
+ *
+ *DESCRIPTION:	Sets found[i] to whether elts[i] is a member of "set", for each of the "n" strings
+ *		in "elts", and returns how many are members. The strings are processed BATCH at
+ *		a time with their chains prefetched.
+ *
+ *COMPLEXITY:	Average Case:	O(n)
+ */
+
+int hasElements (SET *set, char **elts, int n, int *found) {
+
+	int i, j, m, count = 0;
+
+	LIST *chains[BATCH];
+
+	for (i = 0; i < n; i += BATCH) {
+
+		m = n - i < BATCH ? n - i : BATCH;
+
+		findChains (set, elts + i, m, chains);
+
+		for (j = 0; j < m; j++)
+
+			count += found[i + j] = hasItem (chains[j], elts[i + j]);
+	}
+
+	return count;
+}
+
+
+/*FUNCTION:	insertElements
+ *
+ *DESCRIPTION:	Inserts the "n" strings in "elts" into "set", and returns how many were inserted.
+ *		The strings are processed BATCH at a time with their chains prefetched.
+ *
+ *COMPLEXITY:	Average Case:	O(n)
+ */
+
+int insertElements (SET *set, char **elts, int n) {
+
+	int i, j, m, count = 0;
+
+	LIST *chains[BATCH];
+
+	for (i = 0; i < n; i += BATCH) {
+
+		m = n - i < BATCH ? n - i : BATCH;
+
+		findChains (set, elts + i, m, chains);
+
+		for (j = 0; j < m; j++)
+
+			if (!hasItem (chains[j], elts[i + j]) && insertItem (chains[j], elts[i + j]))
+
+				count++;
+	}
+
+	set->count += count;
+
+	return count;
+}
+
+
+/*FUNCTION:	deleteElements
+ *
+ *DESCRIPTION:	Deletes the "n" strings in "elts" from "set", and returns how many were deleted.
+ *		The strings are processed BATCH at a time with their chains prefetched.
+ *
+ *COMPLEXITY:	Average Case:	O(n)
+ */
+
+int deleteElements (SET *set, char **elts, int n) {
+
+	int i, j, m, count = 0;
+
+	LIST *chains[BATCH];
+
+	for (i = 0; i < n; i += BATCH) {
+
+		m = n - i < BATCH ? n - i : BATCH;
+
+		findChains (set, elts + i, m, chains);
+
+		for (j = 0; j < m; j++)
+
+			count += deleteItem (chains[j], elts[i + j]);
+	}
+
+	set->count -= count;
+
+	return count;
+}
+
+
+/*FUNCTION:	rangeOf
+ *
+ *DESCRIPTION:	Returns the range of chains of a build that the chain of "hash" lies in. The
+ *		chains are split into one range of consecutive chains per thread.
+ *
+ *COMPLEXITY:	O(1)
+ */
+
+static int rangeOf (BUILD *b, unsigned hash) {
+
+	return (unsigned long long) (hash & (b->set->size - 1)) * b->threads / b->set->size;
+}
+
+
+/*FUNCTION:	hashKeys
+ *
+ *DESCRIPTION:	Hashes the keys in the slice of the job's thread, and counts how many of them
+ *		belong to each range of chains.
+ *
+ *COMPLEXITY:	O(n / threads)
+ */
+
+static void *hashKeys (void *arg) {
+
+	JOB *job = arg;
+
+	BUILD *b = job->b;
+
+	int i, lo, hi, *counts = &b->offsets[job->t * b->threads];
+
+	lo = (long long) b->n * job->t / b->threads;
+
+	hi = (long long) b->n * (job->t + 1) / b->threads;
+
+	for (i = lo; i < hi; i++) {
+
+		b->hashes[i] = hashString (b->keys[i]);
+
+		counts[rangeOf (b, b->hashes[i])]++;
+	}
+
+	return NULL;
+}
+
+
+/*FUNCTION:	scatterKeys
+ *
+ *DESCRIPTION:	Places the indices of the keys in the slice of the job's thread into the part of
+ *		"order" belonging to their range of chains.
+ *
+ *COMPLEXITY:	O(n / threads)
+ */
+
+static void *scatterKeys (void *arg) {
+
+	JOB *job = arg;
+
+	BUILD *b = job->b;
+
+	int i, lo, hi, *offsets = &b->offsets[job->t * b->threads];
+
+	lo = (long long) b->n * job->t / b->threads;
+
+	hi = (long long) b->n * (job->t + 1) / b->threads;
+
+	for (i = lo; i < hi; i++)
+
+		b->order[offsets[rangeOf (b, b->hashes[i])]++] = i;
+
+	return NULL;
+}
+
+
+/*FUNCTION:	fillChains
+ *
+ *DESCRIPTION:	Inserts the keys belonging to the range of chains of the job's thread. No other
+ *		thread touches those chains, so no locking is needed, and since equal keys
+ *		share a chain only the first of them is inserted.
+ *
+ *COMPLEXITY:	Average Case:	O(n / threads)
+ */
+
+static void *fillChains (void *arg) {
+
+	JOB *job = arg;
+
+	BUILD *b = job->b;
+
+	LIST *list;
+
+	int i, k;
+
+	for (i = b->starts[job->t]; i < b->starts[job->t + 1]; i++) {
+
+		k = b->order[i];
+
+		list = b->set->lists[b->hashes[k] & (b->set->size - 1)];
+
+		if (!hasItem (list, b->keys[k]) && insertItem (list, b->keys[k]))
+
+			job->count++;
+	}
+
+	return NULL;
+}
+
+
+/*FUNCTION:	createSetFromArray
+ *
+ *DESCRIPTION:	Creates and returns a set holding the "n" strings in "keys", built by "threads"
+ *		threads. The chains are split into one range per thread. The threads first hash
+ *		their slices of the keys and sort them by range, then each thread inserts the
+ *		keys of its own range without any locking. Duplicate keys are inserted once.
+ *
+ *COMPLEXITY:	Average Case:	O(n / threads), plus O(threads^2)
+ */
+
+SET *createSetFromArray (char **keys, int n, int threads) {
+
+	SET *set;
+
+	BUILD b;
+
+	JOB *jobs;
+
+	int i, r, t, count;
+
+	if ((set = createSet (n)) == NULL)
+
+		return NULL;
+
+	if (threads < 1)
+
+		threads = 1;
+
+	b.set = set;
+
+	b.keys = keys;
+
+	b.n = n;
+
+	b.threads = threads;
+
+	b.hashes = malloc (n * sizeof(unsigned));
+
+	b.order = malloc (n * sizeof(int));
+
+	b.starts = malloc ((threads + 1) * sizeof(int));
+
+	b.offsets = calloc (threads * threads, sizeof(int));
+
+	jobs = calloc (threads, sizeof(JOB));
+
+	if (b.hashes == NULL || b.order == NULL || b.starts == NULL || b.offsets == NULL || jobs == NULL) {
+
+		free (b.hashes);
+		free (b.order);
+		free (b.starts);
+		free (b.offsets);
+		free (jobs);
+
+		destroySet (set);
+
+		return NULL;
+	}
+
+	for (t = 0; t < threads; t++) {
+
+		jobs[t].b = &b;
+
+		jobs[t].t = t;
+	}
+
+	runParallel (hashKeys, jobs, sizeof(JOB), threads);
+
+	b.starts[0] = 0;			//Turn the counts per thread and range into offsets.
+
+	for (r = 0, i = 0; r < threads; r++) {
+
+		for (t = 0; t < threads; t++) {
+
+			count = b.offsets[t * threads + r];
+
+			b.offsets[t * threads + r] = i;
+
+			i += count;
+		}
+
+		b.starts[r + 1] = i;
+	}
+
+	runParallel (scatterKeys, jobs, sizeof(JOB), threads);
+
+	runParallel (fillChains, jobs, sizeof(JOB), threads);
+
+	for (t = 0; t < threads; t++)
+
+		set->count += jobs[t].count;
+
+	free (b.hashes);
+
+	free (b.order);
+
+	free (b.starts);
+
+	free (b.offsets);
+
+	free (jobs);
+
+	return set;
+}
@@ -27,5 +27,10 @@ int deleteElement (SET *set, char *elt);
 
 char **sortElements (SET *set);
 
+int hasElements (SET *set, char **elts, int n, int *found);
 
+int insertElements (SET *set, char **elts, int n);
 
+int deleteElements (SET *set, char **elts, int n);
+
+SET *createSetFromArray (char **keys, int n, int threads);
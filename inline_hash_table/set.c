@@ -0,0 +1,352 @@
+/*
+ * File:	set.c
+ *
+ * Description:	This file contains the implementation for a set abstract data type.
+ *              The algorithm used to implement the set is a hash table with linear
+ *              probing whose slots hold the strings themselves. A string of up to
+ *              INLINE_MAX characters is copied into its slot, so looking it up reads
+ *              only the table; a longer string is copied to the heap and its slot
+ *              holds a pointer to the copy. Every slot also keeps the full hash code
+ *              of its string, so strings are only compared when the codes are equal.
+ *
+ *              Unlike the other implementations, the set stores copies of the strings
+ *              given to it, so callers keep ownership of their own strings.
+ *              Determining membership, insertion and deletion have constant time for
+ *              the average case.
+ *
+ *              A set is an unordered collection of unique elements. Each element is a string.
+ *
+ */
+
+# include <stdio.h>
+# include <stdlib.h>
+# include <string.h>
+# include "set.h"
+# include "../common/hash.h"
+
+# define EMPTY 0
+# define FILLED 1
+# define DEL 2
+
+# define INLINE_MAX 15 /* The longest string stored within its slot */
+
+# define MAX_LOAD 0.8 /* Fraction of FILLED or DEL slots that triggers a resize */
+# define MIN_SIZE 8 /* The smallest array ever allocated */
+
+/* Definition of a slot of the table, 24 bytes on common platforms */
+typedef struct slot
+{
+  unsigned hash; /* The full hash code of the string */
+
+  unsigned char flag; /* Whether the slot is empty, full, or deleted */
+
+  unsigned char spilled; /* Whether the string is on the heap rather than in `key.str` */
+
+  union
+  {
+    char str[INLINE_MAX + 1]; /* The string itself, if it fits */
+
+    char *ptr; /* Otherwise, the heap copy of the string */
+  } key;
+} SLOT;
+
+/* Definition of the `set` data type */
+struct set
+{
+  int count; /* The number of elements currently in `slots` */
+
+  int size; /* The size of `slots`, a power of two */
+
+  int used; /* The number of slots that are not empty */
+
+  SLOT *slots; /* The array of slots */
+};
+
+/* Private function prototypes */
+static char *slotString (SLOT *slot);
+static int locateElement (SET *set, char *elt, unsigned hash, int *found);
+static int resizeSet (SET *set, int size);
+
+/*
+ * Function:	slotString
+ *
+ * Description: Returns the string stored in the filled `slot`.
+ *
+ * Complexity:  O(1)
+ */
+static char *slotString (SLOT *slot)
+{
+  return slot->spilled ? slot->key.ptr : slot->key.str;
+}
+
+/*
+ * Function:	locateElement
+ *
+ * Description: Returns the location of an element in the `set`, given its `hash`.
+ *              If element present: return its index, and set `found` pointer to 1. If
+ *		element not present, return the index of where it should be inserted, and
+ *		set found pointer to 0.
+ *
+ * Complexity:  O(1) - average case
+ *		O(n) - worst case
+ */
+static int locateElement (SET *set, char *elt, unsigned hash, int *found)
+{
+  int locn, i, deleted = -1;
+
+  SLOT *slot;
+
+  locn = hash & (set->size - 1);
+
+  for (i = 0; i < set->size; i++) {
+
+    slot = &set->slots[locn];
+
+    if (slot->flag == EMPTY) {
+      *found = 0;
+      return deleted != -1 ? deleted : locn;
+    }
+
+    else if (slot->flag == DEL) {
+      if (deleted == -1)
+        deleted = locn;
+    }
+
+    else if (slot->hash == hash && strcmp (slotString (slot), elt) == 0) {
+      *found = 1;
+      return locn;
+    }
+
+    locn = (locn + 1) & (set->size - 1);
+  }
+
+  *found = 0;
+  return deleted;
+}
+
+/*
+ * Function:	resizeSet
+ *
+ * Description: Replaces the slots of `set` with an array of `size` slots, moving every
+ *		filled slot by its stored hash code. Returns 0 if the array could not be
+ *		allocated, leaving `set` unchanged.
+ *
+ * Complexity:  O(n)
+ */
+static int resizeSet (SET *set, int size)
+{
+  int i, locn;
+
+  SLOT *slots;
+
+  if ((slots = malloc (size * sizeof(SLOT))) == NULL)
+    return 0;
+
+  for (i = 0; i < size; i++)
+    slots[i].flag = EMPTY;
+
+  for (i = 0; i < set->size; i++)
+    if (set->slots[i].flag == FILLED) {
+
+      locn = set->slots[i].hash & (size - 1);
+
+      while (slots[locn].flag != EMPTY)
+        locn = (locn + 1) & (size - 1);
+
+      slots[locn] = set->slots[i];
+    }
+
+  free (set->slots);
+
+  set->slots = slots;
+
+  set->size = size;
+
+  set->used = set->count;
+
+  return 1;
+}
+
+/*
+ * Function:	createSet
+ *
+ * Description: Initializes and returns a set with an initial capacity of at least `size`.
+ *		The set grows as elements are inserted.
+ *
+ * Complexity:  O(n)
+ */
+SET *createSet (int size)
+{
+  int i;
+
+  SET *s;
+
+  int slots = MIN_SIZE;
+
+  while (slots < size)
+    slots *= 2;
+
+  s = malloc (sizeof(SET));
+
+  if (s == NULL)
+    return NULL;
+
+  s->slots = malloc (slots * sizeof(SLOT));
+
+  if (s->slots == NULL)
+    return NULL;
+
+  s->count = 0;
+
+  s->size = slots;
+
+  s->used = 0;
+
+  for (i = 0; i < slots; i++)
+    s->slots[i].flag = EMPTY;
+
+  return s;
+}
+
+/*
+ * Function:	insertElement
+ *
+ * Description: Inserts a copy of `elt` into `set`, and returns whether the set changed.
+ *
+ * Complexity:  O(1) - average case
+ *		O(n) - worst case, or when the array has to grow
+ */
+int insertElement (SET *set, char *elt)
+{
+  int locn, found;
+
+  unsigned hash;
+
+  size_t len;
+
+  SLOT *slot;
+
+  len = strlen (elt);
+
+  hash = hashBytes (elt, len);
+
+  locateElement (set, elt, hash, &found);
+
+  if (found)
+    return 0;
+
+  if (set->used + 1 > set->size * MAX_LOAD)
+    if (!resizeSet (set, set->count * 2 >= set->size ? set->size * 2 : set->size))
+      return 0;
+
+  locn = locateElement (set, elt, hash, &found);
+
+  slot = &set->slots[locn];
+
+  if (len > INLINE_MAX) {
+
+    if ((slot->key.ptr = malloc (len + 1)) == NULL)
+      return 0;
+
+    memcpy (slot->key.ptr, elt, len + 1);
+
+    slot->spilled = 1;
+  }
+
+  else {
+
+    memcpy (slot->key.str, elt, len + 1);
+
+    slot->spilled = 0;
+  }
+
+  if (slot->flag == EMPTY)
+    set->used++;
+
+  slot->hash = hash;
+
+  slot->flag = FILLED;
+
+  set->count++;
+
+  return 1;
+}
+
+/*
+ * Function:	numElements
+ *
+ * Description:	Returns the number of elements in `set`
+ *
+ * Complexity:  O(1)
+ */
+int numElements (SET *set)
+{
+  return set->count;
+}
+
+/*
+ * Function:    hasElement
+ *
+ * Description: Returns if `elt` is a member of `set`.
+ *
+ * Complexity:  O(1) - average case
+ *		O(n) - worst case
+ */
+int hasElement (SET *set, char *elt)
+{
+  int found;
+
+  locateElement (set, elt, hashString (elt), &found);
+
+  return found;
+}
+
+/*
+ * Function:    deleteElement
+ *
+ * Description: Deletes `elt` from `set`, and returns whether the set changed.
+ *
+ * Complexity:  O(1) - average case
+ *		O(n) - worst case
+ */
+int deleteElement (SET *set, char *elt)
+{
+  int locn, found;
+
+  locn = locateElement (set, elt, hashString (elt), &found);
+
+  if (!found)
+    return 0;
+
+  if (set->slots[locn].spilled)
+    free (set->slots[locn].key.ptr);
+
+  set->slots[locn].flag = DEL;
+
+  set->count--;
+
+  return 1;
+}
+
+/*
+ * Function:    destroySet
+ *
+ * Description: Deallocates memory associated with `set`, including its copies of
+ *		the strings.
+ *
+ * Complexity:  O(n)
+ */
+void destroySet (SET *set)
+{
+  int i;
+
+  for (i = 0; i < set->size; i++)
+    if (set->slots[i].flag == FILLED && set->slots[i].spilled)
+      free (set->slots[i].key.ptr);
+
+  free (set->slots);
+
+  free (set);
+
+  return;
+}
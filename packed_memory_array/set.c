@@ -0,0 +1,489 @@
+/*
+ * File:	set.c
+ *
+ * Description:	This file contains the implementation for a set abstract data type.
+ *              The algorithm used to implement the set is a packed memory array: a
+ *              sorted array with gaps left between the elements, so that an insertion
+ *              only has to shift the elements up to the next gap.
+ *
+ *              The array is split into segments of SEGMENT slots, and the elements of
+ *              each segment are kept together at its start. A search first does a
+ *              binary search over the first elements of the segments, which are
+ *              copied into an array of their own so that it touches few cache lines
+ *              and pages, then another within the one segment found. An insertion or
+ *              deletion shifts elements within a single segment. When a segment fills
+ *              up, or drains below its lower density, the smallest aligned window of
+ *              segments around it whose density is within bounds is rebalanced by
+ *              spreading its elements evenly over its segments. The bounds are tighter
+ *              for larger windows, so that a large window is rebalanced only after many
+ *              updates within it. When even the whole array is out of bounds it is
+ *              doubled or halved instead. This gives insertion and deletion an
+ *              amortized cost of O(log^2 n) moves.
+ *
+ *              A set is an unordered collection of unique elements. Each element is a string.
+ *
+ */
+
+# include <stdio.h>
+# include <stdlib.h>
+# include <string.h>
+# include "set.h"
+
+# define SEGMENT 32 /* The number of slots in a segment, a power of two */
+# define UPPER_ROOT 0.5 /* The largest density allowed for the whole array */
+# define UPPER_LEAF 0.9 /* The largest density allowed for a window of two segments */
+# define LOWER_ROOT 0.25 /* The smallest density allowed for the whole array */
+# define LOWER_LEAF 0.125 /* The smallest density allowed for a single segment */
+
+/* Definition of the `set` data type */
+struct set
+{
+  int count; /* The number of elements currently in the set */
+
+  int size; /* The number of slots, a power of two and a multiple of SEGMENT */
+
+  char **slots; /* The array of element strings, each segment's elements at its start */
+
+  char **heads; /* The first element of each segment, or NULL if it is empty */
+
+  int *counts; /* The number of elements in each segment */
+};
+
+/* Private function prototypes */
+static int locateSegment (SET *set, char *elt);
+static int locateElement (SET *set, int seg, char *elt, int *found);
+static double upperDensity (SET *set, int level);
+static double lowerDensity (SET *set, int level);
+static void spreadElements (SET *set, int first, int segs, int total);
+static int resizeSet (SET *set, int size);
+static int rebalanceSet (SET *set, int seg, int insert);
+
+/*
+ * Function:	locateSegment
+ *
+ * Description: Returns the segment of `set` that holds `elt` or would hold it: the last
+ *		non-empty segment whose first element is not greater than `elt`, or 0 if
+ *		there is none. Empty segments are skipped over while searching.
+ *
+ * Complexity:  O(logn) - while no long run of segments is empty
+ */
+static int locateSegment (SET *set, char *elt)
+{
+  int low, mid, high, seg, best = 0;
+
+  low = 0;
+
+  high = set->size / SEGMENT - 1;
+
+  while (low <= high) {
+
+    mid = (low + high) / 2;
+
+    for (seg = mid; seg >= low && set->heads[seg] == NULL; seg--)
+      ;
+
+    if (seg < low)
+      low = mid + 1;
+
+    else if (strcmp (set->heads[seg], elt) <= 0) {
+      best = seg;
+      low = mid + 1;
+    }
+
+    else
+      high = seg - 1;
+  }
+
+  return best;
+}
+
+/*
+ * Function:	locateElement
+ *
+ * Description: Returns the location of `elt` within segment `seg` of `set` using binary
+ *		search. If element present: return its index, and set `found` pointer to 1.
+ *		If element not present, return the index of where it would have been, and
+ *		set found pointer to 0.
+ *
+ * Complexity:  O(log SEGMENT)
+ */
+static int locateElement (SET *set, int seg, char *elt, int *found)
+{
+  int low, mid, high, diff;
+
+  low = seg * SEGMENT;
+
+  high = low + set->counts[seg] - 1;
+
+  while (low <= high) {
+
+    mid = (low + high) / 2;
+
+    diff = strcmp (elt, set->slots[mid]);
+
+    if (diff < 0)
+      high = mid - 1;
+
+    else if (diff > 0)
+      low = mid + 1;
+
+    else {
+      *found = 1;
+      return mid;
+    }
+  }
+
+  *found = 0;
+  return low;
+}
+
+/*
+ * Function:	upperDensity
+ *
+ * Description: Returns the largest density allowed for a window of 2^level segments of
+ *		`set`, falling linearly from UPPER_LEAF for two segments to UPPER_ROOT for
+ *		the whole array.
+ *
+ * Complexity:  O(log n)
+ */
+static double upperDensity (SET *set, int level)
+{
+  int height = 0;
+
+  while ((SEGMENT << height) < set->size)
+    height++;
+
+  if (height <= 1)
+    return UPPER_ROOT;
+
+  return UPPER_LEAF - (UPPER_LEAF - UPPER_ROOT) * (level - 1) / (height - 1);
+}
+
+/*
+ * Function:	lowerDensity
+ *
+ * Description: Returns the smallest density allowed for a window of 2^level segments of
+ *		`set`, rising linearly from LOWER_LEAF for one segment to LOWER_ROOT for
+ *		the whole array.
+ *
+ * Complexity:  O(log n)
+ */
+static double lowerDensity (SET *set, int level)
+{
+  int height = 0;
+
+  while ((SEGMENT << height) < set->size)
+    height++;
+
+  if (height == 0)
+    return LOWER_ROOT;
+
+  return LOWER_LEAF + (LOWER_ROOT - LOWER_LEAF) * level / height;
+}
+
+/*
+ * Function:	spreadElements
+ *
+ * Description: Spreads the `total` elements held by the `segs` segments of `set` starting
+ *		at segment `first` evenly over them, keeping their order. The elements are
+ *		first packed together at the start of the window, then moved to their
+ *		segments starting from the last, so that no element is overwritten before
+ *		it is moved.
+ *
+ * Complexity:  O(segs * SEGMENT)
+ */
+static void spreadElements (SET *set, int first, int segs, int total)
+{
+  int i, j, k, lo, hi, start = first * SEGMENT;
+
+  for (i = first, k = start; i < first + segs; i++)
+    for (j = 0; j < set->counts[i]; j++)
+      set->slots[k++] = set->slots[i * SEGMENT + j];
+
+  for (i = segs - 1; i >= 0; i--) {
+
+    lo = (long long) total * i / segs;
+
+    hi = (long long) total * (i + 1) / segs;
+
+    for (j = hi - lo - 1; j >= 0; j--)
+      set->slots[start + i * SEGMENT + j] = set->slots[start + lo + j];
+
+    set->counts[first + i] = hi - lo;
+
+    set->heads[first + i] = hi > lo ? set->slots[start + i * SEGMENT] : NULL;
+  }
+}
+
+/*
+ * Function:	resizeSet
+ *
+ * Description: Moves the elements of `set` into a new array of `size` slots, spread evenly
+ *		over its segments, and returns whether it succeeded.
+ *
+ * Complexity:  O(n)
+ */
+static int resizeSet (SET *set, int size)
+{
+  char **slots, **heads;
+
+  int *counts, i, j, k, segs = size / SEGMENT;
+
+  slots = malloc (size * sizeof(char *));
+
+  heads = malloc (segs * sizeof(char *));
+
+  counts = malloc (segs * sizeof(int));
+
+  if (slots == NULL || heads == NULL || counts == NULL) {
+    free (slots);
+    free (heads);
+    free (counts);
+    return 0;
+  }
+
+  /* Pack the elements into the first segments of the new array, then spread them. */
+
+  for (i = 0, k = 0; i < set->size / SEGMENT; i++)
+    for (j = 0; j < set->counts[i]; j++)
+      slots[k++] = set->slots[i * SEGMENT + j];
+
+  for (i = 0; i < segs; i++, k -= SEGMENT)
+    counts[i] = k <= 0 ? 0 : k < SEGMENT ? k : SEGMENT;
+
+  free (set->slots);
+
+  free (set->heads);
+
+  free (set->counts);
+
+  set->slots = slots;
+
+  set->heads = heads;
+
+  set->counts = counts;
+
+  set->size = size;
+
+  spreadElements (set, 0, segs, set->count);
+
+  return 1;
+}
+
+/*
+ * Function:	rebalanceSet
+ *
+ * Description: Rebalances the smallest window of segments around segment `seg` of `set`
+ *		whose density will be within its bounds once `insert` elements are added,
+ *		where `insert` is 1 before an insertion and 0 after a deletion. If the
+ *		whole array is out of bounds, it is doubled or halved instead. Returns 0
+ *		if a larger array was needed but could not be allocated.
+ *
+ * Complexity:  O(log^2 n) - amortized
+ */
+static int rebalanceSet (SET *set, int seg, int insert)
+{
+  int level, first, segs, i, total;
+
+  for (level = 1; (SEGMENT << level) <= set->size; level++) {
+
+    segs = 1 << level;
+
+    first = seg & ~(segs - 1);
+
+    for (i = first, total = 0; i < first + segs; i++)
+      total += set->counts[i];
+
+    if (insert ? total + 1 <= upperDensity (set, level) * segs * SEGMENT
+	       : total >= lowerDensity (set, level) * segs * SEGMENT) {
+      spreadElements (set, first, segs, total);
+      return 1;
+    }
+  }
+
+  if (insert)
+    return resizeSet (set, set->size * 2);
+
+  if (set->size > SEGMENT)
+    resizeSet (set, set->size / 2);
+
+  return 1;
+}
+
+/*
+ * Function:	createSet
+ *
+ * Description: Initializes and returns an empty set. The set grows and shrinks as elements
+ *		are inserted and deleted, so `size` is not used: an array sized for it up
+ *		front would be filled from one end, leaving long runs of empty segments
+ *		for searches to skip over, whereas every array the set grows into starts
+ *		with its elements spread over all of its segments.
+ *
+ * Complexity:  O(1)
+ */
+SET *createSet (int size)
+{
+  SET *s;
+
+  int i, slots = SEGMENT;
+
+  s = malloc (sizeof(SET));
+
+  if (s == NULL)
+    return NULL;
+
+  s->count = 0;
+
+  s->size = slots;
+
+  s->slots = malloc (slots * sizeof(char *));
+
+  s->heads = malloc (slots / SEGMENT * sizeof(char *));
+
+  s->counts = malloc (slots / SEGMENT * sizeof(int));
+
+  if (s->slots == NULL || s->heads == NULL || s->counts == NULL) {
+    free (s->slots);
+    free (s->heads);
+    free (s->counts);
+    free (s);
+    return NULL;
+  }
+
+  for (i = 0; i < slots / SEGMENT; i++) {
+    s->heads[i] = NULL;
+    s->counts[i] = 0;
+  }
+
+  return s;
+}
+
+/*
+ * Function:	insertElement
+ *
+ * Description: Inserts `elt` into `set`, and returns whether the set changed. If the
+ *		segment `elt` belongs in is full, the window around it is rebalanced first.
+ *
+ * Complexity:  O(logn) - if `elt` is already present
+ *		O(log^2 n) - amortized, if `elt` is not already present
+ */
+int insertElement (SET *set, char *elt)
+{
+  int i, seg, locn, found;
+
+  seg = locateSegment (set, elt);
+
+  locn = locateElement (set, seg, elt, &found);
+
+  if (found)
+    return 0;
+
+  if (set->counts[seg] == SEGMENT) {
+
+    if (!rebalanceSet (set, seg, 1))
+      return 0;
+
+    seg = locateSegment (set, elt);
+
+    locn = locateElement (set, seg, elt, &found);
+  }
+
+  /* Ensure that the segment remains sorted: */
+
+  for (i = seg * SEGMENT + set->counts[seg]; i > locn; i--)
+    set->slots[i] = set->slots[i - 1];
+
+  set->slots[locn] = elt;
+
+  set->heads[seg] = set->slots[seg * SEGMENT];
+
+  set->counts[seg]++;
+
+  set->count++;
+
+  return 1;
+}
+
+/*
+ * Function:	numElements
+ *
+ * Description:	Returns the number of elements in `set`.
+ *
+ * Complexity:  O(1)
+ */
+int numElements (SET *set)
+{
+  return set->count;
+}
+
+/*
+ * Function:    hasElement
+ *
+ * Description: Returns whether `elt` is a member of `set`.
+ *
+ * Complexity:  O(logn)
+ */
+int hasElement (SET *set, char *elt)
+{
+  int found;
+
+  locateElement (set, locateSegment (set, elt), elt, &found);
+
+  return found;
+}
+
+/*
+ * Function:    deleteElement
+ *
+ * Description: Deletes `elt` from `set`, and returns whether the set changed. If its
+ *		segment drains below the lower density, the window around it is
+ *		rebalanced.
+ *
+ * Complexity:  O(logn) - if element not present
+ *		O(log^2 n) - amortized, if element is present
+ */
+int deleteElement (SET *set, char *elt)
+{
+  int i, seg, locn, found;
+
+  seg = locateSegment (set, elt);
+
+  locn = locateElement (set, seg, elt, &found);
+
+  if (!found)
+    return 0;
+
+  for (i = locn + 1; i < seg * SEGMENT + set->counts[seg]; i++)
+    set->slots[i - 1] = set->slots[i];
+
+  set->counts[seg]--;
+
+  set->count--;
+
+  set->heads[seg] = set->counts[seg] > 0 ? set->slots[seg * SEGMENT] : NULL;
+
+  if (set->counts[seg] < lowerDensity (set, 0) * SEGMENT)
+    rebalanceSet (set, seg, 0);
+
+  return 1;
+}
+
+/*
+ * Function:    destroySet
+ *
+ * Description: Deallocates memory associated with `set`.
+ *
+ * Complexity:  O(1)
+ */
+void destroySet (SET *set)
+{
+  free (set->counts);
+
+  free (set->heads);
+
+  free (set->slots);
+
+  free (set);
+
+  return;
+}
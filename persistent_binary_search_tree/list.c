@@ -0,0 +1,742 @@
+/*
+*  File:		list.c
+*
+*  Description:	This file contains the public and private function definitions for a list abstract
+*               data type in the form of a persistent Binary Search Tree.  Items are stored in
+*               sorted order in a BST, and duplicates are allowed.  The tree is kept balanced as an
+*               AVL tree, and each node records the number of nodes in its subtree, as in
+*               ../binary_search_tree.
+*
+*               A list is one version of a tree whose nodes may be shared with other versions.
+*               A snapshot is a new version sharing the root of the list, so taking one is
+*               constant time.  Each node counts the links to it, from parent nodes and from the
+*               roots of versions, and is changed in place only while that count is one, which
+*               means no other version can reach it.  An insertion or deletion copies each shared
+*               node it would change, from the first shared node on its path down, and leaves the
+*               original to the versions still holding it.  Without snapshots, nothing is shared
+*               and nothing is copied.
+*
+*               Since shared nodes are never changed, any number of threads may each read or
+*               update a version of their own without locking.  The counts are updated
+*               atomically, and a node is freed, with the links from it released in turn, by
+*               whichever thread drops its count to zero.  A single version must still be used
+*               by one thread at a time, including to take snapshots of it.  Nodes are shared
+*               between lists and freed by any thread, so each is allocated with malloc rather
+*               than from a pool.
+*
+*               Every traversal is iterative, except for freeing a version.  An insertion or
+*               deletion records the links it follows on a stack, which the height bound of an
+*               AVL tree keeps short.
+*
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include "list.h"
+
+#define MAX_HEIGHT 64		//No AVL tree of fewer than 2^31 nodes is higher
+
+/* Datatype declarations: */
+
+typedef struct node {
+
+  char *data;
+
+  struct node *left;
+
+  struct node *right;
+
+  int height;			//Height of the subtree rooted here, a leaf being 1
+
+  int size;			//Number of nodes in the subtree rooted here
+
+  atomic_int links;		//Number of parents and versions holding the node
+
+} NODE;
+
+struct list {
+
+  int count;
+
+  NODE *root;
+};
+
+/* Private function prototypes: */
+
+static int height (NODE *node);
+
+static int size (NODE *node);
+
+static void updateNode (NODE *node);
+
+static void rotateLeft (NODE **link);
+
+static void rotateRight (NODE **link);
+
+static void rebalance (NODE ***path, int depth);
+
+static NODE *newNode (char *item, NODE *left, NODE *right, int height, int size);
+
+static void holdNode (NODE *node);
+
+static void releaseNode (NODE *node);
+
+static NODE *ownNode (NODE **link);
+
+
+/*
+ *Function:	createList
+ *
+ *Description:	Creates, initializes, and returns a list
+ *
+ *Complexity:	O(1)
+ *
+ */
+
+LIST *createList (void) {
+
+  LIST *list;
+
+  if ((list = malloc (sizeof(LIST))) == NULL)
+
+    return NULL;
+
+  list->count = 0;
+
+  list->root = NULL;
+
+  return list;
+}
+
+
+/*
+ *Function:	snapshotList
+ *
+ *Description:	Creates and returns a new list holding the same items as "list," sharing all of
+ *		its nodes.  Either list may then be changed without the other seeing it.
+ *
+ *Complexity:	O(1)
+ *
+ */
+
+LIST *snapshotList (LIST *list) {
+
+  LIST *snapshot;
+
+  if ((snapshot = malloc (sizeof(LIST))) == NULL)
+
+    return NULL;
+
+  snapshot->count = list->count;
+
+  snapshot->root = list->root;
+
+  holdNode (list->root);
+
+  return snapshot;
+}
+
+
+/*
+ *Function:	destroyList
+ *
+ *Description:	Deallocates memory associated with "list".  Its nodes are released, and those no
+ *		other version holds are freed.  The items themselves belong to the caller.
+ *
+ *Complexity:	O(n) - if no other version shares the nodes
+ *		O(1) - if another version shares the root
+ *
+ */
+
+void destroyList (LIST *list) {
+
+  releaseNode (list->root);
+
+  free (list);
+}
+
+
+/*
+ *Function:	numItems
+ *
+ *Description:	Returns the number of items in "list"
+ *
+ *Complexity:	O(1)
+ *
+ */
+
+int numItems (LIST *list) {
+
+  return list->count;
+}
+
+
+/*
+ *Function:	hasItem
+ *
+ *Description:	Returns one if "item" is present in "list," and zero otherwise
+ *
+ *Complexity:	O(logn)
+ *
+ */
+
+int hasItem (LIST *list, char *item) {
+
+  NODE *node;
+
+  int diff;
+
+  node = list->root;
+
+  while (node) {
+
+    diff = strcmp (item, node->data);
+
+    if (diff == 0)
+
+      return 1;
+
+    node = diff < 0 ? node->left : node->right;
+  }
+
+  return 0;
+}
+
+
+/*
+ *Function:	newNode
+ *
+ *Description:	Allocates and returns a node holding "item" with the given children, height and
+ *		size, linked once, or returns NULL if out of memory.  The children are not held.
+ *
+ *Complexity:	O(1)
+ *
+ */
+
+static NODE *newNode (char *item, NODE *left, NODE *right, int height, int size) {
+
+  NODE *node;
+
+  if ((node = malloc (sizeof(NODE))) == NULL)
+
+    return NULL;
+
+  node->data = item;
+
+  node->left = left;
+
+  node->right = right;
+
+  node->height = height;
+
+  node->size = size;
+
+  atomic_init (&node->links, 1);
+
+  return node;
+}
+
+
+/*
+ *Function:	holdNode
+ *
+ *Description:	Counts one more link to "node," if it is not NULL
+ *
+ *Complexity:	O(1)
+ *
+ */
+
+static void holdNode (NODE *node) {
+
+  if (node)
+
+    atomic_fetch_add (&node->links, 1);
+}
+
+
+/*
+ *Function:	releaseNode
+ *
+ *Description:	Counts one less link to "node," if it is not NULL.  A node left with none is
+ *		freed and its links to its children released in turn, the left recursively and
+ *		the right in the same loop.
+ *
+ *Complexity:	O(k), where k is the number of nodes freed
+ *
+ */
+
+static void releaseNode (NODE *node) {
+
+  NODE *right;
+
+  while (node && atomic_fetch_sub (&node->links, 1) == 1) {
+
+    releaseNode (node->left);
+
+    right = node->right;
+
+    free (node);
+
+    node = right;
+  }
+}
+
+
+/*
+ *Function:	ownNode
+ *
+ *Description:	Makes the node at "link," which is in a node or list the caller may change, one
+ *		that only this version holds, and returns it.  A node held elsewhere is replaced
+ *		at "link" by a copy, which holds its children, and the link to the original is
+ *		released.  Returns NULL, leaving the node in place, if out of memory.
+ *
+ *Complexity:	O(1)
+ *
+ */
+
+static NODE *ownNode (NODE **link) {
+
+  NODE *node = *link, *copy;
+
+  if (atomic_load (&node->links) == 1)
+
+    return node;
+
+  if ((copy = newNode (node->data, node->left, node->right, node->height, node->size)) == NULL)
+
+    return NULL;
+
+  holdNode (copy->left);
+
+  holdNode (copy->right);
+
+  *link = copy;
+
+  releaseNode (node);
+
+  return copy;
+}
+
+
+/*
+ *Function:	height
+ *
+ *Description:	Returns the height of the subtree rooted at "node", zero if it is empty
+ *
+ *Complexity:	O(1)
+ *
+ */
+
+static int height (NODE *node) {
+
+  return node ? node->height : 0;
+}
+
+
+/*
+ *Function:	size
+ *
+ *Description:	Returns the number of nodes in the subtree rooted at "node", zero if it is empty
+ *
+ *Complexity:	O(1)
+ *
+ */
+
+static int size (NODE *node) {
+
+  return node ? node->size : 0;
+}
+
+
+/*
+ *Function:	updateNode
+ *
+ *Description:	Recomputes the height and size of "node" from those of its children
+ *
+ *Complexity:	O(1)
+ *
+ */
+
+static void updateNode (NODE *node) {
+
+  int left = height (node->left), right = height (node->right);
+
+  node->height = (left > right ? left : right) + 1;
+
+  node->size = size (node->left) + size (node->right) + 1;
+}
+
+
+/*
+ *Function:	rotateLeft
+ *
+ *Description:	Replaces the subtree at "link" by its right child, which takes the old root as
+ *		its left child
+ *
+ *Complexity:	O(1)
+ *
+ */
+
+static void rotateLeft (NODE **link) {
+
+  NODE *root = *link, *pivot = root->right;
+
+  root->right = pivot->left;
+
+  pivot->left = root;
+
+  updateNode (root);
+
+  updateNode (pivot);
+
+  *link = pivot;
+}
+
+
+/*
+ *Function:	rotateRight
+ *
+ *Description:	Replaces the subtree at "link" by its left child, which takes the old root as
+ *		its right child
+ *
+ *Complexity:	O(1)
+ *
+ */
+
+static void rotateRight (NODE **link) {
+
+  NODE *root = *link, *pivot = root->left;
+
+  root->left = pivot->right;
+
+  pivot->right = root;
+
+  updateNode (root);
+
+  updateNode (pivot);
+
+  *link = pivot;
+}
+
+
+/*
+ *Function:	rebalance
+ *
+ *Description:	Walks back up the "depth" links on "path", from the deepest, after a node below
+ *		them was inserted or deleted, updating each height and size and rotating any node whose
+ *		subtrees now differ in height by two.  A child leaning the other way is rotated
+ *		first, turning the double imbalance into a single one.  The nodes on "path" are
+ *		already owned by the list, and the children a rotation changes are made so; if one
+ *		cannot be copied, the node is left unbalanced rather than shared nodes changed.
+ *
+ *Complexity:	O(logn)
+ *
+ */
+
+static void rebalance (NODE ***path, int depth) {
+
+  NODE **link, *node;
+
+  int balance;
+
+  while (depth > 0) {
+
+    link = path[--depth];
+
+    node = *link;
+
+    balance = height (node->left) - height (node->right);
+
+    if (balance > 1 && ownNode (&node->left) &&		//Left heavy
+	(height (node->left->left) >= height (node->left->right) || ownNode (&node->left->right))) {
+
+      if (height (node->left->left) < height (node->left->right))
+
+	rotateLeft (&node->left);
+
+      rotateRight (link);
+    }
+
+    else if (balance < -1 && ownNode (&node->right) &&	//Right heavy
+	     (height (node->right->right) >= height (node->right->left) || ownNode (&node->right->left))) {
+
+      if (height (node->right->right) < height (node->right->left))
+
+	rotateRight (&node->right);
+
+      rotateLeft (link);
+    }
+
+    else
+
+      updateNode (node);
+  }
+}
+
+
+/*
+ *Function:	insertItem
+ *
+ *Description:	Inserts "item" into list as a new leaf, and returns whether list changed. An
+ *		item equal to one already present goes to its right.  Each node on the way down is
+ *		copied first if another version holds it.
+ *
+ *Complexity:	O(logn)
+ *
+ */
+
+int insertItem (LIST *list, char *item) {
+
+  NODE *new, **link, **path[MAX_HEIGHT];
+
+  int depth = 0;
+
+  if ((new = newNode (item, NULL, NULL, 1, 1)) == NULL)
+
+    return 0;
+
+  link = &list->root;
+
+  while (*link) {				//Locate null subtree for insertion
+
+    if (!ownNode (link)) {
+
+      free (new);
+
+      return 0;
+    }
+
+    path[depth++] = link;
+
+    link = strcmp (item, (*link)->data) < 0 ? &(*link)->left : &(*link)->right;
+  }
+
+  *link = new;
+
+  rebalance (path, depth);
+
+  list->count++;
+
+  return 1;
+}
+
+
+/*
+ *Function:	deleteItem
+ *
+ *Description:	Deletes the first instance of "item" found in "list," and returns whether the
+ *		list changed.  A node with two children takes the item of its successor, the
+ *		leftmost node of its right subtree, and the successor's node is removed in its
+ *		place.  Each node on the way down, but not the one removed, is copied first if
+ *		another version holds it, so the list is searched once beforehand to copy nothing
+ *		when "item" is absent.  The removed node's child is linked to its parent, and its
+ *		own link released.  The item itself belongs to the caller and is not freed.
+ *
+ *Complexity:	O(logn)
+ *
+ */
+
+int deleteItem (LIST *list, char *item) {
+
+  NODE **link, **path[MAX_HEIGHT], *del, *child;
+
+  int depth = 0, diff;
+
+  if (!hasItem (list, item))			//Not found
+
+    return 0;
+
+  link = &list->root;
+
+  while ((diff = strcmp (item, (*link)->data)) != 0) {
+
+    if (!ownNode (link))
+
+      return 0;
+
+    path[depth++] = link;
+
+    link = diff < 0 ? &(*link)->left : &(*link)->right;
+  }
+
+  if ((*link)->left && (*link)->right) {	//Two children: find the successor
+
+    if ((del = ownNode (link)) == NULL)
+
+      return 0;
+
+    path[depth++] = link;
+
+    link = &del->right;
+
+    while ((*link)->left) {
+
+      if (!ownNode (link))
+
+	return 0;
+
+      path[depth++] = link;
+
+      link = &(*link)->left;
+    }
+
+    del->data = (*link)->data;
+  }
+
+  del = *link;
+
+  child = del->left ? del->left : del->right;
+
+  holdNode (child);
+
+  *link = child;
+
+  releaseNode (del);
+
+  rebalance (path, depth);
+
+  list->count--;
+
+  return 1;
+}
+
+
+/*
+ *Function:	rangeItems
+ *
+ *Description:	Passes each item of "list" that is not less than "lo" and is less than "hi" to
+ *		"visit" in sorted order, along with "arg", and returns the number of items visited.
+ *		A NULL bound leaves that end of the range open. The traversal stops early once
+ *		"visit" returns zero. The list must not be changed during the traversal.
+ *
+ *		The traversal is inorder, with a stack of the nodes whose left subtrees are being
+ *		visited.  It starts by descending towards "lo", stacking only the nodes that are
+ *		not below it, so subtrees entirely below the range are never entered.
+ *
+ *Complexity:	O(logn + k), where k is the number of items visited
+ *
+ */
+
+int rangeItems (LIST *list, char *lo, char *hi, int (*visit) (char *item, void *arg), void *arg) {
+
+  NODE *node, *stack[MAX_HEIGHT];
+
+  int top = 0, visited = 0;
+
+  node = list->root;
+
+  while (node) {
+
+    if (lo && strcmp (node->data, lo) < 0)	//Node and left subtree below range
+
+      node = node->right;
+
+    else {
+
+      stack[top++] = node;
+
+      node = node->left;
+    }
+  }
+
+  while (top > 0) {
+
+    node = stack[--top];
+
+    if (hi && strcmp (node->data, hi) >= 0)	//Node and everything after it above range
+
+      break;
+
+    visited++;
+
+    if (!visit (node->data, arg))
+
+      break;
+
+    for (node = node->right; node; node = node->left)
+
+      stack[top++] = node;
+  }
+
+  return visited;
+}
+
+
+/*
+ *Function:	rankOf
+ *
+ *Description:	Returns the number of items in "list" less than "item," which is the position
+ *		"item" has or would have in sorted order, counting from zero.  Each step right
+ *		passes a node and its left subtree, whose sizes are added up on the way down.
+ *
+ *Complexity:	O(logn)
+ *
+ */
+
+int rankOf (LIST *list, char *item) {
+
+  NODE *node;
+
+  int rank = 0;
+
+  node = list->root;
+
+  while (node) {
+
+    if (strcmp (node->data, item) < 0) {
+
+      rank += size (node->left) + 1;
+
+      node = node->right;
+    }
+
+    else
+
+      node = node->left;
+  }
+
+  return rank;
+}
+
+
+/*
+ *Function:	selectKth
+ *
+ *Description:	Returns the item at position "k" of "list" in sorted order, counting from zero,
+ *		or NULL if there is no such position.  The size of the left subtree of each node
+ *		tells whether the item is there, at the node, or in the right subtree.
+ *
+ *Complexity:	O(logn)
+ *
+ */
+
+char *selectKth (LIST *list, int k) {
+
+  NODE *node;
+
+  int left;
+
+  if (k < 0 || k >= list->count)
+
+    return NULL;
+
+  node = list->root;
+
+  while ((left = size (node->left)) != k) {
+
+    if (k < left)
+
+      node = node->left;
+
+    else {
+
+      k -= left + 1;
+
+      node = node->right;
+    }
+  }
+
+  return node->data;
+}
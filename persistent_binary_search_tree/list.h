@@ -0,0 +1,31 @@
+/*
+ * File: list.h
+ *
+ * Description: This file contains the public function type declarations for a list
+ *		abstract data type for strings.  A list is an ordered collection of
+ *		elements.  A snapshot of a list is an independent list holding the
+ *		same elements, taken in constant time.
+ *
+ */
+
+typedef struct list LIST;
+
+LIST *createList (void);
+
+void destroyList (LIST *list);
+
+int numItems (LIST *list);
+
+int hasItem (LIST *list, char *item);
+
+int insertItem (LIST *list, char *item);
+
+int deleteItem (LIST *list, char *item);
+
+int rangeItems (LIST *list, char *lo, char *hi, int (*visit) (char *item, void *arg), void *arg);
+
+int rankOf (LIST *list, char *item);
+
+char *selectKth (LIST *list, int k);
+
+LIST *snapshotList (LIST *list);
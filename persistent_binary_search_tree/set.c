@@ -0,0 +1,282 @@
+/*
+ * File:		set.c
+ *
+ * Description:	This file contains the function definitions for a set abstract datatype for strings.
+ *
+ *              This implementation relies on a list abstract datatype (which happens to be in the form of a
+ *              persistent binary search tree) to store elements.  A snapshot of a set wraps a
+ *              snapshot of its list, so the two share their nodes until either is changed, and
+ *              either may be read or changed by another thread without locking (see list.c).
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "list.h"
+#include "set.h"
+
+/*Datatype declaration(s): */
+
+struct set {
+
+  LIST *list;
+};
+
+typedef struct prefix {		//State of a prefix scan, passed through rangeItems
+
+  char *prefix;
+
+  int length;
+
+  int (*visit) (char *elt, void *arg);
+
+  void *arg;
+
+  int visited;			//The number of elements passed to "visit"
+
+} PREFIX;
+
+/*Private function prototypes: */
+
+static int visitPrefixed (char *elt, void *arg);
+
+/*
+ *Function:	createSet
+ *
+ *Description:	Creates, initializes and returns a set with a maximum capacity of "size"
+ *
+ *Complexity:	O(1)
+ *
+ */
+
+SET *createSet (int size) {
+
+  SET *set;
+
+  if ((set = malloc (sizeof(SET))) == NULL)
+
+    return NULL;
+
+  if ((set->list = createList()) == NULL) {
+
+    free (set);
+
+    return NULL;
+  }
+
+  return set;
+}
+
+
+/*
+ *Function:	destroySet
+ *
+ *Description:	Deallocates memory associated with "set"
+ *
+ *Complexity:	O(n) - if no other set shares its nodes
+ *		O(1) - if a snapshot shares them all
+ */
+
+void destroySet (SET *set) {
+
+  destroyList (set->list);
+
+  free (set);
+}
+
+
+/*
+ *Function:	numElements
+ *
+ *Description:	Returns the number of elements in "set"
+ *
+ *Complexity:	O(1)
+ *
+ */
+
+int numElements (SET *set) {
+
+  return numItems (set->list);
+}
+
+
+/*
+ *Function:	hasElement
+ *
+ *Description:	Returns 1 if "elt" is present in "set," and zero otherwise
+ *
+ *Complexity:	O(logn)
+ */
+
+int hasElement (SET *set, char *elt) {
+
+  return hasItem (set->list, elt);
+}
+
+
+/*
+ *Function:	insertElement
+ *
+ *Description:	Inserts "elt" into "set," and returns whether the set changed
+ *
+ *Complexity:	O(logn)
+ */
+
+int insertElement (SET *set, char *elt) {
+
+  if (hasItem (set->list, elt))
+
+    return 0;
+
+  if (insertItem (set->list, elt))
+
+    return 1;
+
+  return 0;
+}
+
+
+/*
+ *Function:	deleteElement
+ *
+ *Description:	Removes "elt" from "set," and returns whether the set changed
+ *
+ *Complexity:	O(logn)
+ */
+
+int deleteElement (SET *set, char *elt) {
+
+  return deleteItem (set->list, elt);
+}
+
+
+/*
+ *Function:	rangeScan
+ *
+ *Description:	Passes each element of "set" that is not less than "lo" and is less than "hi" to
+ *		"visit" in sorted order, along with "arg", and returns the number of elements
+ *		visited. A NULL bound leaves that end of the range open. The scan stops early
+ *		once "visit" returns zero. The set must not be changed during the scan.
+ *
+ *Complexity:	O(logn + k), where k is the number of elements visited
+ */
+
+int rangeScan (SET *set, char *lo, char *hi, int (*visit) (char *elt, void *arg), void *arg) {
+
+  return rangeItems (set->list, lo, hi, visit, arg);
+}
+
+
+/*
+ *Function:	visitPrefixed
+ *
+ *Description:	Passes "elt" on to the callback of the prefix scan "arg" if it begins with the
+ *		prefix, and returns zero to end the traversal at the first element that does not.
+ *
+ *Complexity:	O(m), where m is the length of the prefix
+ */
+
+static int visitPrefixed (char *elt, void *arg) {
+
+  PREFIX *scan = arg;
+
+  if (strncmp (elt, scan->prefix, scan->length) != 0)
+
+    return 0;
+
+  scan->visited++;
+
+  return scan->visit (elt, scan->arg);
+}
+
+
+/*
+ *Function:	prefixScan
+ *
+ *Description:	Passes each element of "set" that begins with "prefix" to "visit" in sorted order,
+ *		along with "arg", and returns the number of elements visited. The elements with a
+ *		prefix follow one another from the prefix itself, so the traversal starts there
+ *		and ends at the first element without it. As with rangeScan, the scan stops early
+ *		once "visit" returns zero.
+ *
+ *Complexity:	O(logn + k), where k is the number of elements visited
+ */
+
+int prefixScan (SET *set, char *prefix, int (*visit) (char *elt, void *arg), void *arg) {
+
+  PREFIX scan;
+
+  scan.prefix = prefix;
+
+  scan.length = strlen (prefix);
+
+  scan.visit = visit;
+
+  scan.arg = arg;
+
+  scan.visited = 0;
+
+  rangeItems (set->list, prefix, NULL, visitPrefixed, &scan);
+
+  return scan.visited;
+}
+
+
+/*
+ *Function:	rankElement
+ *
+ *Description:	Returns the number of elements of "set" less than "elt," which is the position
+ *		"elt" has or would have in sorted order, counting from zero
+ *
+ *Complexity:	O(logn)
+ */
+
+int rankElement (SET *set, char *elt) {
+
+  return rankOf (set->list, elt);
+}
+
+
+/*
+ *Function:	selectElement
+ *
+ *Description:	Returns the element at position "k" of "set" in sorted order, counting from zero,
+ *		or NULL if there is no such position
+ *
+ *Complexity:	O(logn)
+ */
+
+char *selectElement (SET *set, int k) {
+
+  return selectKth (set->list, k);
+}
+
+
+/*
+ *Function:	snapshotSet
+ *
+ *Description:	Creates and returns a set holding the same elements as "set," sharing its nodes.
+ *		Changes to either set afterwards are not seen by the other, and each must be
+ *		destroyed on its own.
+ *
+ *Complexity:	O(1)
+ */
+
+SET *snapshotSet (SET *set) {
+
+  SET *snapshot;
+
+  if ((snapshot = malloc (sizeof(SET))) == NULL)
+
+    return NULL;
+
+  if ((snapshot->list = snapshotList (set->list)) == NULL) {
+
+    free (snapshot);
+
+    return NULL;
+  }
+
+  return snapshot;
+}
@@ -0,0 +1,35 @@
+/*
+ *File:		set.h
+ *
+ *Description:	This file contains the public function and type
+ *		declarations for a set abstract data type for strings.  A
+ *		set is an unordered collection of unique elements.  A snapshot
+ *		of a set is an independent set holding the same elements,
+ *		taken in constant time.
+ *
+ *
+ */
+
+typedef struct set SET;
+
+SET *createSet (int size);
+
+void destroySet (SET *set);
+
+int numElements (SET *set);
+
+int hasElement (SET *set, char *elt);
+
+int insertElement (SET *set, char *elt);
+
+int deleteElement (SET *set, char *elt);
+
+int rangeScan (SET *set, char *lo, char *hi, int (*visit) (char *elt, void *arg), void *arg);
+
+int prefixScan (SET *set, char *prefix, int (*visit) (char *elt, void *arg), void *arg);
+
+int rankElement (SET *set, char *elt);
+
+char *selectElement (SET *set, int k);
+
+SET *snapshotSet (SET *set);
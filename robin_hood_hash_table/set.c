@@ -0,0 +1,372 @@
+/*
+ * File:	set.c
+ *
+ * Description:	This file contains the implementation for a set abstract data type.
+ *              The algorithm used to implement the set is a hash table with Robin Hood
+ *              linear probing. Each slot records how far its element sits from the slot
+ *              it hashed to (its probe length). During insertion an element that has
+ *              probed further than the occupant of a slot takes that slot, and the
+ *              occupant continues probing instead, which keeps probe lengths close to
+ *              one another. Deletion shifts the following elements of the cluster back
+ *              by one slot, so no deleted markers are ever left behind.
+ *
+ *              A lookup stops as soon as it reaches a slot whose element has probed less
+ *              than the lookup has, so unsuccessful searches end early too. Determining
+ *              membership, insertion and deletion have constant time for the average case.
+ *
+ *              A set is an unordered collection of unique elements. Each element is a string.
+ *
+ */
+
+# include <stdio.h>
+# include <stdlib.h>
+# include <string.h>
+# include "set.h"
+# include "../common/hash.h"
+
+# define EMPTY -1 /* Probe length recorded for an empty slot */
+
+# define MAX_LOAD 0.9 /* Fraction of filled slots that triggers a resize */
+# define MIN_SIZE 8 /* The smallest array ever allocated */
+
+/* Definition of the `set` data type */
+struct set
+{
+  int count; /* The number of elements currently in `elts` */
+
+  int size; /* The size of `elts`, a power of two */
+
+  char **elts; /* The array of element strings */
+
+  int *dist; /* The probe length of the element in each slot, or EMPTY */
+};
+
+/* Private function prototypes */
+static int locateElement (SET *set, char *elt, int *found);
+static void placeElement (SET *set, char *elt);
+static int resizeSet (SET *set, int size);
+
+/*
+ * Function:	locateElement
+ *
+ * Description: Returns the location of an element in the `set` using the hash function.
+ *              If element present: return its index, and set `found` pointer to 1. If
+ *		element not present, return the index where the search stopped, and set
+ *		found pointer to 0. Strings are only compared when the slot's element
+ *		hashed to the same slot as `elt`.
+ *
+ * Complexity:  O(1) - average case
+ *		O(n) - worst case, where every key maps to the same location
+ */
+static int locateElement (SET *set, char *elt, int *found)
+{
+  int locn, d;
+
+  locn = hashString (elt) & (set->size - 1);
+
+  for (d = 0; set->dist[locn] >= d; d++) {
+
+    if (set->dist[locn] == d && strcmp (set->elts[locn], elt) == 0) {
+      *found = 1;
+      return locn;
+    }
+
+    locn = (locn + 1) & (set->size - 1);
+  }
+
+  *found = 0;
+  return locn;
+}
+
+/*
+ * Function:	placeElement
+ *
+ * Description: Stores `elt`, which must not already be present, in `set`. Whenever the
+ *		element being placed has probed further than a slot's occupant, the two
+ *		are exchanged and placement continues with the displaced element.
+ *
+ * Complexity:  O(1) - average case
+ *		O(n) - worst case
+ */
+static void placeElement (SET *set, char *elt)
+{
+  int locn, d, tmpdist;
+
+  char *tmp;
+
+  locn = hashString (elt) & (set->size - 1);
+
+  for (d = 0; set->dist[locn] != EMPTY; d++) {
+
+    if (set->dist[locn] < d) {
+
+      tmp = set->elts[locn];
+      set->elts[locn] = elt;
+      elt = tmp;
+
+      tmpdist = set->dist[locn];
+      set->dist[locn] = d;
+      d = tmpdist;
+    }
+
+    locn = (locn + 1) & (set->size - 1);
+  }
+
+  set->elts[locn] = elt;
+
+  set->dist[locn] = d;
+}
+
+/*
+ * Function:	resizeSet
+ *
+ * Description: Replaces the array of `set` with one of `size` slots and places every
+ *		element again. Returns 0 if the array could not be allocated, leaving
+ *		`set` unchanged.
+ *
+ * Complexity:  O(n)
+ */
+static int resizeSet (SET *set, int size)
+{
+  int i, oldSize;
+
+  char **oldElts;
+
+  int *oldDist;
+
+  oldSize = set->size;
+
+  oldElts = set->elts;
+
+  oldDist = set->dist;
+
+  if ((set->elts = malloc (size * sizeof(char *))) == NULL) {
+    set->elts = oldElts;
+    return 0;
+  }
+
+  if ((set->dist = malloc (size * sizeof(int))) == NULL) {
+    free (set->elts);
+    set->elts = oldElts;
+    set->dist = oldDist;
+    return 0;
+  }
+
+  set->size = size;
+
+  for (i = 0; i < size; i++)
+    set->dist[i] = EMPTY;
+
+  for (i = 0; i < oldSize; i++)
+    if (oldDist[i] != EMPTY)
+      placeElement (set, oldElts[i]);
+
+  free (oldElts);
+
+  free (oldDist);
+
+  return 1;
+}
+
+/*
+ * Function:	createSet
+ *
+ * Description: Initializes and returns a set with an initial capacity of at least `size`.
+ *		The set grows as elements are inserted.
+ *
+ * Complexity:  O(n)
+ */
+SET *createSet (int size)
+{
+  int i;
+
+  SET *s;
+
+  int slots = MIN_SIZE;
+
+  while (slots < size)
+    slots *= 2;
+
+  size = slots;
+
+  s = malloc (sizeof(SET));
+
+  if (s == NULL)
+    return NULL;
+
+  s->elts = malloc (size * sizeof(char *));
+
+  if (s->elts == NULL)
+    return NULL;
+
+  s->dist = malloc (size * sizeof(int));
+
+  if (s->dist == NULL)
+    return NULL;
+
+  s->count = 0;
+
+  s->size = size;
+
+  for (i = 0; i < size; i++)
+    s->dist[i] = EMPTY;
+
+  return s;
+}
+
+/*
+ * Function:	insertElement
+ *
+ * Description: Inserts `elt` into `set`, and returns whether the set changed.
+ *
+ * Complexity:  O(1) - average case
+ *		O(n) - worst case, or when the array has to grow
+ */
+int insertElement (SET *set, char *elt)
+{
+  int found;
+
+  locateElement (set, elt, &found);
+
+  if (found)
+    return 0;
+
+  if (set->count + 1 > set->size * MAX_LOAD)
+    if (!resizeSet (set, set->size * 2))
+      return 0;
+
+  placeElement (set, elt);
+
+  set->count++;
+
+  return 1;
+}
+
+/*
+ * Function:	numElements
+ *
+ * Description:	Returns the number of elements in `set`
+ *
+ * Complexity:  O(1)
+ */
+int numElements (SET *set)
+{
+  return set->count;
+}
+
+/*
+ * Function:    hasElement
+ *
+ * Description: Returns if `elt` is a member of `set`.
+ *
+ * Complexity:  O(1) - average case
+ *		O(n) - worst case
+ */
+int hasElement (SET *set, char *elt)
+{
+  int found;
+
+  locateElement (set, elt, &found);
+
+  return found;
+}
+
+/*
+ * Function:    deleteElement
+ *
+ * Description: Deletes `elt` from `set`, and returns whether the set changed. The
+ *		elements following it in its cluster are shifted back one slot, closer
+ *		to the slots they hashed to, until an empty slot or an element already
+ *		in its own slot is reached.
+ *
+ * Complexity:  O(1) - average case
+ *		O(n) - worst case
+ */
+int deleteElement (SET *set, char *elt)
+{
+  int locn, next, found;
+
+  locn = locateElement (set, elt, &found);
+
+  if (!found)
+    return 0;
+
+  next = (locn + 1) & (set->size - 1);
+
+  while (set->dist[next] > 0) {
+
+    set->elts[locn] = set->elts[next];
+
+    set->dist[locn] = set->dist[next] - 1;
+
+    locn = next;
+
+    next = (next + 1) & (set->size - 1);
+  }
+
+  set->dist[locn] = EMPTY;
+
+  set->count--;
+
+  return 1;
+}
+
+/*
+ * Function:    maxProbeLength
+ *
+ * Description: Returns the largest probe length of any element in `set`, that is, how
+ *		many slots past the one it hashed to the furthest element is stored.
+ *
+ * Complexity:  O(n)
+ */
+int maxProbeLength (SET *set)
+{
+  int i, max = 0;
+
+  for (i = 0; i < set->size; i++)
+    if (set->dist[i] > max)
+      max = set->dist[i];
+
+  return max;
+}
+
+/*
+ * Function:    meanProbeLength
+ *
+ * Description: Returns the average probe length of the elements in `set`.
+ *
+ * Complexity:  O(n)
+ */
+double meanProbeLength (SET *set)
+{
+  int i;
+
+  double total = 0;
+
+  if (set->count == 0)
+    return 0;
+
+  for (i = 0; i < set->size; i++)
+    if (set->dist[i] != EMPTY)
+      total += set->dist[i];
+
+  return total / set->count;
+}
+
+/*
+ * Function:    destroySet
+ *
+ * Description: Deallocates memory associated with `set`.
+ *
+ * Complexity:  O(1)
+ */
+void destroySet (SET *set)
+{
+  free (set->dist);
+
+  free (set->elts);
+
+  free (set);
+
+  return;
+}
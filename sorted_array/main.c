@@ -8,8 +8,8 @@
  *		second of which is optional.  All words in the first file
  *		are inserted into the set and the counts of total words and
  *		total words in the set are printed.  If the second file is
- *		given then all words in the second file are deleted from the
- *		set and the count printed.
+ *		given then all words in the second file are read and deleted
+ *		from the set in one batch, and the count printed.
  *
  * Author:      Brian Jenkins (bj@jenkinz.com)
  * Date:        05/05/2012
@@ -31,7 +31,8 @@ int main (int argc, char *argv [])
     SET *set;
     FILE *fp;
     char buffer [BUFSIZ];
-    int words;
+    char **batch;
+    int words, n, max;
 
     /* Check usage and open the first file. */
 
@@ -76,10 +77,30 @@ int main (int argc, char *argv [])
 	}
 
 
-	/* Delete all words in the second file. */
+	/* Delete all words in the second file, as a single batch. */
 
-	while (fscanf (fp, "%s", buffer) == 1)
-	    deleteElement (set, buffer);
+	n = 0;
+	max = 1024;
+	batch = malloc (max * sizeof (char *));
+
+	while (batch != NULL && fscanf (fp, "%s", buffer) == 1) {
+	    if (n == max)
+		batch = realloc (batch, (max *= 2) * sizeof (char *));
+	    if (batch != NULL && (batch [n] = strdup (buffer)) != NULL)
+		n ++;
+	}
+
+	if (batch == NULL) {
+	    fprintf (stderr, "%s: out of memory\n", argv [0]);
+	    exit (EXIT_FAILURE);
+	}
+
+	deleteElements (set, batch, n);
+
+	while (n > 0)
+	    free (batch [-- n]);
+
+	free (batch);
 
 	printf ("%d remaining words\n", numElements (set));
     }
@@ -4,6 +4,41 @@
  * Description:	This file contains the implementation for a set abstract data type.
  *              The algorithm used to implement the set is a sorted array with binary search.
  *
+ *              A set can also be built from an array of keys by several threads, each
+ *              sorting a slice of the array, after which the sorted slices are merged
+ *              in pairs, the merges of each round running in parallel.
+ *
+ *              A batch of elements can be inserted or deleted at once. The batch is
+ *              sorted, and then applied in a single merge or compaction pass over the
+ *              array, rather than shifting the array once per element.
+ *
+ *              The union, intersection and difference of two sets are computed by a
+ *              merge that gallops over runs of one set that fall between two elements
+ *              of the other, so intersecting a small set with a large one costs little
+ *              more than the small one. Large merges are split by key range over threads.
+ *
+ *              The elements between two bounds, or with a given prefix, can be visited
+ *              in sorted order by a callback, starting from their lower bound.
+ *
+ *              Beside each element the array keeps its first eight bytes as an integer,
+ *              so that a search compares integers in one contiguous array and only
+ *              reads a string when its prefix ties with the element sought.
+ *
+ *              A set that is only read can be frozen. The prefixes of its elements are
+ *              then also laid out in Eytzinger order, the order of a breadth-first walk
+ *              of the implicit binary search tree, where the children of position k are
+ *              at 2k and 2k + 1. The first levels of every search share a few cache
+ *              lines, and the search computes the next position from each comparison of
+ *              integers instead of branching on it, while the descendants a few levels
+ *              down are prefetched. Only elements whose prefixes tie with the one sought
+ *              are compared as strings, in the sorted array, which is kept. Changing the
+ *              set thaws it.
+ *
+ *              A set can instead be frozen with a learned index: a piecewise linear
+ *              model of the position of each element as a function of its prefix, which
+ *              is never more than a given error off for an element of the set, so that
+ *              a lookup searches a small window around the predicted position.
+ *
  *              A set is an unordered collection of unique elements. Each element is a string.
  *
  * Author:      Brian Jenkins (bj@jenkinz.com)
@@ -14,7 +49,11 @@
 # include <stdio.h>
 # include <stdlib.h>
 # include <string.h>
+# include <float.h>
 # include "set.h"
+# include "../common/parallel.h"
+# include "../common/prefetch.h"
+# include "../common/prefix.h"
 
 /* Definition of the `set` data type */
 struct set
@@ -24,34 +63,164 @@ struct set
   int size; /* The maximum size of `elts` */
 
   char **elts; /* The array of element strings */
+
+  unsigned long long *prefixes; /* The first eight bytes of each element, as big-endian integers */
+
+  unsigned long long *eytz; /* The prefixes in Eytzinger order from index 1 while frozen, else NULL */
+
+  int *ranks; /* The index in `elts` of the element at each position of `eytz` */
+
+  struct segment *model; /* The segments of the learned index while learned, else NULL */
+
+  int segments; /* The number of segments in `model` */
+
+  int error; /* The most a segment's prediction may be off by for an element */
 };
 
-/* Private function prototype */
+/* One linear piece of a learned index */
+typedef struct segment
+{
+  unsigned long long key; /* The first prefix the segment covers */
+
+  int pos; /* The index of the first element with that prefix */
+
+  double slope; /* The number of elements per unit of prefix past `key` */
+} SEGMENT;
+
+/* The work on one run of a build: sorting it, or merging it with the next run */
+typedef struct job
+{
+  char **src; /* The array holding the runs */
+
+  char **dst; /* The array the merged run is written to */
+
+  int lo, n1; /* The start and length of the first run */
+
+  int mid, n2; /* The start and length of the second run, if any */
+
+  int count; /* The length of the result, which is written starting at `lo` */
+} JOB;
+
+/* The operations of the set algebra */
+# define UNION 0
+# define INTERSECTION 1
+# define DIFFERENCE 2
+
+/* The work on one key range of a set operation */
+typedef struct slice
+{
+  char **a, **b; /* The elements of the two sets in the range */
+
+  int na, nb; /* The number of elements of each set in the range */
+
+  char **dst; /* Where the result is written, with room for na + nb strings */
+
+  int op; /* The operation: UNION, INTERSECTION or DIFFERENCE */
+
+  int count; /* The length of the result */
+} SLICE;
+
+/* The length of the range of prefixes that a search scans rather than halves */
+# define SCAN 16
+
+/* Private function prototypes */
+static void fillPrefixes (SET *set, int lo);
+static int searchPrefixes (SET *set, unsigned long long prefix, int low, int high);
+static int searchTies (SET *set, char *elt, unsigned long long prefix, int low, int *found);
 static int locateElement (SET *set, char *elt, int *found);
+static int searchLearned (SET *set, char *elt);
+static int layOut (SET *set, int i, int k);
+static int searchFrozen (SET *set, char *elt);
+static int compareStrings (const void *a, const void *b);
+static void *sortRun (void *arg);
+static void *mergeRuns (void *arg);
+static char **sortBatch (char **elts, int n, int *count);
+static int gallop (char **elts, int lo, int hi, char *key);
+static void *combineSlice (void *arg);
+static SET *combineSets (SET *a, SET *b, int op, int threads);
+static int scanFrom (SET *set, int i, char *hi, int length, int (*visit) (char *elt, void *arg), void *arg);
 
 /*
- * Function:	locateElement
+ * Function:	fillPrefixes
  *
- * Description: A private function that returns the location of an element `elt` in the `set` using binary search.
- *		If element present: return its index, and set `found` pointer to 1. If
- *		element not present, return the index of where it would have been, and
- *		set found pointer to 0.
+ * Description: Computes the prefixes of the elements of `set` from index `lo` on.
  *
- * Complexity:  O(logn)
+ * Complexity:  O(n)
  */
-static int locateElement (SET *set, char *elt, int *found)
+static void fillPrefixes (SET *set, int lo)
 {
-  int low, mid, high, diff;
+  int i;
 
-  low = 0;
+  for (i = lo; i < set->count; i++)
+    set->prefixes[i] = prefixOf (set->elts[i]);
+}
+
+/*
+ * Function:	searchPrefixes
+ *
+ * Description: Returns the index of the first element of `set` from `low` up to `high`
+ *		whose prefix is not less than `prefix`, or `high` if there is none. The
+ *		search halves the range until it is SCAN prefixes long, then compares
+ *		them all in a loop without branches that the compiler can vectorize.
+ *
+ * Complexity:  O(logm), where m = high - low
+ */
+static int searchPrefixes (SET *set, unsigned long long prefix, int low, int high)
+{
+  int i, mid, less;
+
+  while (high - low > SCAN) {
+
+    mid = (low + high) / 2;
+
+    if (set->prefixes[mid] < prefix)
+      low = mid + 1;
+    else
+      high = mid;
+  }
+
+  for (i = low, less = 0; i < high; i++)
+    less += set->prefixes[i] < prefix;
+
+  return low + less;
+}
+
+/*
+ * Function:	searchTies
+ *
+ * Description: Finishes a search for `elt`, whose prefix is `prefix`, given the index `low`
+ *		of the first element whose prefix is not less. Returns the location of `elt`
+ *		and sets `found` as locateElement does. If `elt` is shorter than eight
+ *		bytes an equal prefix is an equal string; otherwise the end of the run of
+ *		elements sharing its prefix is found by galloping, and the run is searched
+ *		with strcmp on the rest of the strings.
+ *
+ * Complexity:  O(logm), where m is the number of elements with the same prefix
+ */
+static int searchTies (SET *set, char *elt, unsigned long long prefix, int low, int *found)
+{
+  int mid, high, bound, diff;
+
+  if (low == set->count || set->prefixes[low] != prefix) {
+    *found = 0;
+    return low;
+  }
+
+  if ((prefix & 0xff) == 0) {
+    *found = 1;
+    return low;
+  }
+
+  for (bound = 1; low + bound < set->count && set->prefixes[low + bound] == prefix; bound *= 2)
+    ;
 
-  high = set->count - 1;
+  high = (low + bound < set->count ? low + bound : set->count) - 1;
 
   while (low <= high) {
 
     mid = (low + high) / 2;
 
-    diff = (strcmp (elt, set->elts[mid]) );
+    diff = set->prefixes[mid] != prefix ? -1 : strcmp (elt + 8, set->elts[mid] + 8);
 
     if (diff < 0)
 
@@ -72,6 +241,28 @@ static int locateElement (SET *set, char *elt, int *found)
   return low;
 }
 
+/*
+ * Function:	locateElement
+ *
+ * Description: A private function that returns the location of an element `elt` in the `set` using binary search.
+ *		If element present: return its index, and set `found` pointer to 1. If
+ *		element not present, return the index of where it would have been, and
+ *		set found pointer to 0.
+ *
+ *		The search runs on the prefixes, which are contiguous, so it reads no
+ *		string until it reaches the elements whose prefix equals that of `elt`.
+ *
+ * Complexity:  O(logn)
+ */
+static int locateElement (SET *set, char *elt, int *found)
+{
+  unsigned long long prefix;
+
+  prefix = prefixOf (elt);
+
+  return searchTies (set, elt, prefix, searchPrefixes (set, prefix, 0, set->count), found);
+}
+
 /*
  * Function:	createSet
  *
@@ -94,8 +285,22 @@ SET *createSet (int size)
 
   s->elts = malloc (size * sizeof(char*));
 
-  if (s->elts == NULL)
+  s->prefixes = malloc (size * sizeof(unsigned long long));
+
+  s->eytz = NULL;
+
+  s->ranks = NULL;
+
+  s->model = NULL;
+
+  s->segments = 0;
+
+  if (s->elts == NULL || s->prefixes == NULL) {
+    free (s->elts);
+    free (s->prefixes);
+    free (s);
     return NULL;
+  }
 
   return s;
 }
@@ -103,7 +308,8 @@ SET *createSet (int size)
 /*
  * Function:	insertElement
  *
- * Description: Inserts `elt` into `set`, and returns whether the set changed.
+ * Description: Inserts `elt` into `set`, and returns whether the set changed. A frozen
+ *		set is thawed first.
  *
  * Complexity:  O(logn) - if `elt` is already present
  *		O(n)    - if `elt` not already present
@@ -120,13 +326,19 @@ int insertElement (SET *set, char *elt)
   if (found)
     return 0;
 
+  thawSet (set);
+
   /*Ensure that array remains sorted: */
 
-  for (i = set->count; i > locn; i--)
+  for (i = set->count; i > locn; i--) {
     set->elts[i] = set->elts[i - 1];
+    set->prefixes[i] = set->prefixes[i - 1];
+  }
 
   set->elts[locn] = elt;
 
+  set->prefixes[locn] = prefixOf (elt);
+
   set->count++;
 
   return 1;
@@ -145,6 +357,99 @@ int numElements (SET *set)
   return set->count;
 }
 
+/*
+ * Function:	sortElements
+ *
+ * Description:	Returns a newly allocated array of the elements of `set` in sorted order,
+ *		or NULL if out of memory. The array holds numElements (set) strings, which
+ *		are still owned by the set.
+ *
+ * Complexity:  O(n)
+ */
+char **sortElements (SET *set)
+{
+  char **elts;
+
+  if ((elts = malloc ((set->count > 0 ? set->count : 1) * sizeof(char *))) == NULL)
+    return NULL;
+
+  memcpy (elts, set->elts, set->count * sizeof(char *));
+
+  return elts;
+}
+
+/*
+ * Function:	scanFrom
+ *
+ * Description: Passes the elements of `set` from index `i` on to `visit` in sorted order,
+ *		stopping before the first element that is not less than `hi`, unless `hi`
+ *		is NULL, or that does not share its first `length` characters with `hi`,
+ *		if `length` is not negative. Also stops once `visit` returns 0. Returns
+ *		the number of elements visited.
+ *
+ * Complexity:  O(k), where k is the number of elements visited
+ */
+static int scanFrom (SET *set, int i, char *hi, int length, int (*visit) (char *elt, void *arg), void *arg)
+{
+  int visited = 0;
+
+  for (; i < set->count; i++) {
+
+    if (length >= 0 && strncmp (set->elts[i], hi, length) != 0)
+      break;
+
+    if (length < 0 && hi != NULL && strcmp (set->elts[i], hi) >= 0)
+      break;
+
+    visited++;
+
+    if (!visit (set->elts[i], arg))
+      break;
+  }
+
+  return visited;
+}
+
+/*
+ * Function:	rangeScan
+ *
+ * Description: Passes each element of `set` that is not less than `lo` and is less than
+ *		`hi` to `visit` in sorted order, along with `arg`, and returns the number
+ *		of elements visited. A NULL bound leaves that end of the range open. The
+ *		scan stops early once `visit` returns 0. The strings are the set's own,
+ *		and the set must not be changed during the scan.
+ *
+ * Complexity:  O(logn + k), where k is the number of elements visited
+ */
+int rangeScan (SET *set, char *lo, char *hi, int (*visit) (char *elt, void *arg), void *arg)
+{
+  int locn, found;
+
+  locn = lo == NULL ? 0 : locateElement (set, lo, &found);
+
+  return scanFrom (set, locn, hi, -1, visit, arg);
+}
+
+/*
+ * Function:	prefixScan
+ *
+ * Description: Passes each element of `set` that begins with `prefix` to `visit` in sorted
+ *		order, along with `arg`, and returns the number of elements visited. The
+ *		elements with a prefix follow one another, starting where the prefix
+ *		itself would be inserted. As with rangeScan, the scan stops early once
+ *		`visit` returns 0.
+ *
+ * Complexity:  O(logn + k), where k is the number of elements visited
+ */
+int prefixScan (SET *set, char *prefix, int (*visit) (char *elt, void *arg), void *arg)
+{
+  int locn, found;
+
+  locn = locateElement (set, prefix, &found);
+
+  return scanFrom (set, locn, prefix, strlen (prefix), visit, arg);
+}
+
 /*
  * Function:    hasElement
  *
@@ -156,6 +461,12 @@ int hasElement (SET *set, char *elt)
 {
   int locn, found;
 
+  if (set->eytz != NULL)
+    return searchFrozen (set, elt);
+
+  if (set->model != NULL)
+    return searchLearned (set, elt);
+
   locn = locateElement (set, elt, &found);
 
   return found;
@@ -164,7 +475,8 @@ int hasElement (SET *set, char *elt)
 /*
  * Function:    deleteElement
  *
- * Description: Deletes `elt` from `set`, and returns whether the set changed.
+ * Description: Deletes `elt` from `set`, and returns whether the set changed. A frozen
+ *		set is thawed first.
  *
  * Complexity:  O(logn) - if element not present
  *		O(n)    - if element is present
@@ -178,8 +490,12 @@ int deleteElement (SET *set, char *elt)
   if (!found)
     return 0;
 
-  for (i = locn + 1; i < set->count; i++)
+  thawSet (set);
+
+  for (i = locn + 1; i < set->count; i++) {
     set->elts[i - 1] = set->elts[i];
+    set->prefixes[i - 1] = set->prefixes[i];
+  }
 
   set->count--;
 
@@ -187,15 +503,871 @@ int deleteElement (SET *set, char *elt)
 }
 
 /*
- * Function:    destroySet
+ * Function:	layOut
  *
- * Description: Deallocates memory associated with `set`.
+ * Description: Copies the prefixes of the sorted elements of `set` from index `i` on,
+ *		and their indices, into the subtree of the Eytzinger array rooted at
+ *		position `k`, by walking it in order, and returns the index of the first
+ *		element not copied.
  *
- * Complexity: O(1)
+ * Complexity:  O(m), where m is the size of the subtree
  */
-void destroySet (SET *set)
+static int layOut (SET *set, int i, int k)
 {
-  free (set->elts);
+  if (k <= set->count) {
+
+    i = layOut (set, i, 2 * k);
+
+    set->ranks[k] = i;
+
+    set->eytz[k] = set->prefixes[i++];
+
+    i = layOut (set, i, 2 * k + 1);
+  }
+
+  return i;
+}
+
+/*
+ * Function:	searchFrozen
+ *
+ * Description: Returns whether `elt` is a member of the frozen `set`. The search descends
+ *		the Eytzinger array of prefixes to the right of every prefix less than that
+ *		of `elt` and to the left otherwise, so the position it ends at encodes the
+ *		last left turn, which is at the first element whose prefix is not less.
+ *		The sixteen positions four levels below the current one are consecutive and
+ *		are prefetched together, since with no branch to predict nothing else would
+ *		load them ahead of time. Unless the prefix found is that of `elt`, `elt` is
+ *		not present; otherwise the elements whose prefixes tie are searched in the
+ *		sorted array as locateElement does.
+ *
+ * Complexity:  O(logn)
+ */
+static int searchFrozen (SET *set, char *elt)
+{
+  unsigned long long prefix;
+
+  unsigned k = 1;
+
+  int found;
+
+  prefix = prefixOf (elt);
+
+  while (k <= (unsigned) set->count) {
+    PREFETCH (set->eytz + 16 * k);
+    PREFETCH (set->eytz + 16 * k + 8);
+    k = 2 * k + (set->eytz[k] < prefix);
+  }
+
+  /* Undo the right turns made after the last left turn, and that left turn. */
+
+  while (k & 1)
+    k >>= 1;
+
+  k >>= 1;
+
+  if (k == 0 || set->eytz[k] != prefix)
+    return 0;
+
+  searchTies (set, elt, prefix, set->ranks[k], &found);
+
+  return found;
+}
+
+/*
+ * Function:	freezeSet
+ *
+ * Description: Lays out the prefixes of the elements of `set` in Eytzinger order as well,
+ *		so that later lookups wait on fewer cache misses, and returns whether it
+ *		succeeded. The set stays frozen until it is thawed or changed.
+ *
+ * Complexity:  O(n)
+ */
+int freezeSet (SET *set)
+{
+  free (set->model);
+
+  set->model = NULL;
+
+  set->segments = 0;
+
+  if (set->eytz == NULL) {
+
+    set->eytz = malloc ((set->count + 1) * sizeof(unsigned long long));
+
+    set->ranks = malloc ((set->count + 1) * sizeof(int));
+  }
+
+  if (set->eytz == NULL || set->ranks == NULL) {
+    thawSet (set);
+    return 0;
+  }
+
+  layOut (set, 0, 1);
+
+  return 1;
+}
+
+/*
+ * Function:	thawSet
+ *
+ * Description: Releases the Eytzinger layout of `set`, if it is frozen.
+ *
+ * Complexity:  O(1)
+ */
+void thawSet (SET *set)
+{
+  free (set->eytz);
+
+  set->eytz = NULL;
+
+  free (set->ranks);
+
+  set->ranks = NULL;
+
+  free (set->model);
+
+  set->model = NULL;
+
+  set->segments = 0;
+}
+
+/*
+ * Function:	learnSet
+ *
+ * Description: Freezes `set` with a learned index instead of the Eytzinger layout, and
+ *		returns whether it succeeded. The index is a piecewise linear function
+ *		from prefixes to positions that is never more than `error` positions off
+ *		for an element of the set. It is built in one pass: a segment starts at
+ *		an element, and each following prefix narrows the range of slopes that
+ *		keep every element so far within the error, until a prefix leaves no
+ *		slope and starts the next segment. A run of equal prefixes is one point,
+ *		at the first of the run. The set stays learned until it is thawed or
+ *		changed.
+ *
+ * Complexity:  O(n)
+ */
+int learnSet (SET *set, int error)
+{
+  SEGMENT *model, *shrunk;
+
+  double low, high, dx, a, b;
+
+  int i, j, n;
+
+  thawSet (set);
+
+  if (error < 1)
+    error = 1;
+
+  if ((model = malloc ((set->count > 0 ? set->count : 1) * sizeof(SEGMENT))) == NULL)
+    return 0;
+
+  for (i = 0, n = 0; i < set->count; i = j, n++) {
+
+    model[n].key = set->prefixes[i];
+
+    model[n].pos = i;
+
+    low = 0;
+
+    high = DBL_MAX;
+
+    for (j = i + 1; j < set->count && set->prefixes[j] == set->prefixes[i]; j++)
+      ;
+
+    while (j < set->count) {
+
+      dx = set->prefixes[j] - set->prefixes[i];
+
+      a = (j - i - error) / dx;
+
+      b = (j - i + error) / dx;
+
+      if (a > high || b < low)
+	break;
+
+      if (a > low)
+	low = a;
+
+      if (b < high)
+	high = b;
+
+      for (j++; j < set->count && set->prefixes[j] == set->prefixes[j - 1]; j++)
+	;
+    }
+
+    model[n].slope = high == DBL_MAX ? 0 : (low + high) / 2;
+  }
+
+  if ((shrunk = realloc (model, (n > 0 ? n : 1) * sizeof(SEGMENT))) != NULL)
+    model = shrunk;
+
+  set->model = model;
+
+  set->segments = n;
+
+  set->error = error;
+
+  return 1;
+}
+
+/*
+ * Function:	searchLearned
+ *
+ * Description: Returns whether `elt` is a member of the learned `set`. A binary search of
+ *		the segments finds the one covering the prefix of `elt`, which predicts its
+ *		position, and only the positions within the error of the prediction are
+ *		searched. The element may lie outside them if it is not in the set, so if
+ *		the answer falls at an edge of the window, the rest of the segment on that
+ *		side is searched as well.
+ *
+ * Complexity:  O(logs + log(error)), where s is the number of segments
+ */
+static int searchLearned (SET *set, char *elt)
+{
+  unsigned long long prefix;
+
+  double guess;
+
+  int low, mid, high, first, last, locn, found;
+
+  prefix = prefixOf (elt);
+
+  /* Find the last segment whose first prefix is not greater than that of `elt`. */
+
+  low = 0;
+
+  high = set->segments - 1;
+
+  while (low <= high) {
+
+    mid = (low + high) / 2;
+
+    if (set->model[mid].key <= prefix)
+      low = mid + 1;
+    else
+      high = mid - 1;
+  }
+
+  if (high < 0) {
+    searchTies (set, elt, prefix, 0, &found);
+    return found;
+  }
+
+  /* The element sought can only lie from the first element of the segment to the first of the next. */
+
+  first = set->model[high].pos;
+
+  last = high + 1 < set->segments ? set->model[high + 1].pos : set->count;
+
+  guess = first + set->model[high].slope * (prefix - set->model[high].key);
+
+  if (guess > last)
+    guess = last;
+
+  low = (int) guess - set->error - 1 > first ? (int) guess - set->error - 1 : first;
+
+  high = (int) guess + set->error + 2 < last ? (int) guess + set->error + 2 : last;
+
+  locn = searchPrefixes (set, prefix, low, high);
+
+  if (locn == high && high < last)
+    locn = searchPrefixes (set, prefix, high, last);
+
+  else if (locn == low && low > first && set->prefixes[low - 1] >= prefix)
+    locn = searchPrefixes (set, prefix, first, low);
+
+  searchTies (set, elt, prefix, locn, &found);
+
+  return found;
+}
+
+/*
+ * Function:	compareStrings
+ *
+ * Description: Compares the strings pointed to by `a` and `b`, for use with qsort.
+ *
+ * Complexity:  O(1) - for strings of bounded length
+ */
+static int compareStrings (const void *a, const void *b)
+{
+  return strcmp (*(char **) a, *(char **) b);
+}
+
+/*
+ * Function:	sortRun
+ *
+ * Description: Sorts the first run of a job in place and removes its duplicates.
+ *
+ * Complexity:  O(mlogm), where m is the length of the run
+ */
+static void *sortRun (void *arg)
+{
+  JOB *job = arg;
+
+  char **elts = job->src + job->lo;
+
+  int i;
+
+  qsort (elts, job->n1, sizeof(char *), compareStrings);
+
+  job->count = 0;
+
+  for (i = 0; i < job->n1; i++)
+    if (job->count == 0 || strcmp (elts[i], elts[job->count - 1]) != 0)
+      elts[job->count++] = elts[i];
+
+  return NULL;
+}
+
+/*
+ * Function:	mergeRuns
+ *
+ * Description: Merges the two sorted runs of a job into `dst`, keeping one copy of any
+ *		string found in both.
+ *
+ * Complexity:  O(m), where m is the total length of the runs
+ */
+static void *mergeRuns (void *arg)
+{
+  JOB *job = arg;
+
+  int i, j, k, diff;
+
+  i = job->lo;
+
+  j = job->mid;
+
+  k = job->lo;
+
+  while (i < job->lo + job->n1 && j < job->mid + job->n2) {
+
+    diff = strcmp (job->src[i], job->src[j]);
+
+    if (diff <= 0)
+      job->dst[k++] = job->src[i++];
+    else
+      job->dst[k++] = job->src[j++];
+
+    if (diff == 0)
+      j++;
+  }
+
+  while (i < job->lo + job->n1)
+    job->dst[k++] = job->src[i++];
+
+  while (j < job->mid + job->n2)
+    job->dst[k++] = job->src[j++];
+
+  job->count = k - job->lo;
+
+  return NULL;
+}
+
+/*
+ * Function:	createSetFromArray
+ *
+ * Description: Creates and returns a set with a maximum capacity of `n` holding the `n`
+ *		strings in `keys`, built by `threads` threads. Each thread sorts a slice of
+ *		the keys and removes its duplicates, then the sorted runs are merged in
+ *		pairs, every merge of a round on its own thread, until one run is left.
+ *		Duplicate keys are inserted once.
+ *
+ * Complexity:  O((n/threads)log(n) + n) - the final merge reads every key
+ */
+SET *createSetFromArray (char **keys, int n, int threads)
+{
+  SET *set;
+
+  JOB *jobs;
+
+  char **tmp, **swap;
+
+  int i, runs;
+
+  if (threads < 1)
+    threads = 1;
+
+  if ((set = createSet (n)) == NULL)
+    return NULL;
+
+  tmp = malloc (n * sizeof(char *));
+
+  jobs = malloc (threads * sizeof(JOB));
+
+  if (tmp == NULL || jobs == NULL) {
+    free (tmp);
+    free (jobs);
+    destroySet (set);
+    return NULL;
+  }
+
+  memcpy (set->elts, keys, n * sizeof(char *));
+
+  for (i = 0; i < threads; i++) {
+    jobs[i].src = set->elts;
+    jobs[i].lo = (long long) n * i / threads;
+    jobs[i].n1 = (long long) n * (i + 1) / threads - jobs[i].lo;
+  }
+
+  runParallel (sortRun, jobs, sizeof(JOB), threads);
+
+  /* Each round merges run 2i + 1 into run 2i, and leaves a last odd run alone. */
+
+  for (runs = threads; runs > 1; runs = (runs + 1) / 2) {
+
+    for (i = 0; i < runs / 2; i++) {
+      jobs[i].src = set->elts;
+      jobs[i].dst = tmp;
+      jobs[i].lo = jobs[2 * i].lo;
+      jobs[i].n1 = jobs[2 * i].count;
+      jobs[i].mid = jobs[2 * i + 1].lo;
+      jobs[i].n2 = jobs[2 * i + 1].count;
+    }
+
+    if (runs % 2 == 1) {
+      jobs[i].src = set->elts;
+      jobs[i].dst = tmp;
+      jobs[i].lo = jobs[runs - 1].lo;
+      jobs[i].n1 = jobs[runs - 1].count;
+      jobs[i].mid = 0;
+      jobs[i].n2 = 0;
+    }
+
+    runParallel (mergeRuns, jobs, sizeof(JOB), (runs + 1) / 2);
+
+    swap = set->elts;
+
+    set->elts = tmp;
+
+    tmp = swap;
+  }
+
+  set->count = jobs[0].count;
+
+  fillPrefixes (set, 0);
+
+  free (tmp);
+
+  free (jobs);
+
+  return set;
+}
+
+/*
+ * Function:	sortBatch
+ *
+ * Description: Returns a sorted copy of the `n` strings in `elts` without duplicates, and
+ *		sets `count` to its length, or returns NULL if out of memory.
+ *
+ * Complexity:  O(nlogn)
+ */
+static char **sortBatch (char **elts, int n, int *count)
+{
+  JOB job;
+
+  job.src = malloc ((n > 0 ? n : 1) * sizeof(char *));
+
+  if (job.src == NULL)
+    return NULL;
+
+  memcpy (job.src, elts, n * sizeof(char *));
+
+  job.lo = 0;
+
+  job.n1 = n;
+
+  sortRun (&job);
+
+  *count = job.count;
+
+  return job.src;
+}
+
+/*
+ * Function:    insertElements
+ *
+ * Description: Inserts the `n` strings in `elts` into `set`, and returns how many were
+ *		inserted. The batch is sorted and its strings already in the set are
+ *		dropped, then the array is merged with it from the back, so that every
+ *		element moves at most once. Unlike insertElement, the array grows if the
+ *		new elements do not fit, and 0 is returned if it cannot.
+ *
+ * Complexity:  O(n + mlogm), where n is the number of elements and m the batch size
+ */
+int insertElements (SET *set, char **elts, int n)
+{
+  char **batch, **grown;
+
+  unsigned long long *prefixes;
+
+  int i, j, k, m, found;
+
+  if ((batch = sortBatch (elts, n, &m)) == NULL)
+    return 0;
+
+  for (i = 0, k = 0; i < m; i++) {
+    locateElement (set, batch[i], &found);
+    if (!found)
+      batch[k++] = batch[i];
+  }
+
+  if (set->count + k > set->size) {
+
+    if ((grown = realloc (set->elts, (set->count + k) * sizeof(char *))) == NULL) {
+      free (batch);
+      return 0;
+    }
+
+    set->elts = grown;
+
+    if ((prefixes = realloc (set->prefixes, (set->count + k) * sizeof(unsigned long long))) == NULL) {
+      free (batch);
+      return 0;
+    }
+
+    set->prefixes = prefixes;
+
+    set->size = set->count + k;
+  }
+
+  if (k > 0)
+    thawSet (set);
+
+  /* Merge from the back, filling the array from its new end. */
+
+  i = set->count - 1;
+
+  j = k - 1;
+
+  while (j >= 0) {
+
+    if (i >= 0 && strcmp (set->elts[i], batch[j]) > 0) {
+      set->elts[i + j + 1] = set->elts[i];
+      set->prefixes[i + j + 1] = set->prefixes[i];
+      i--;
+    }
+
+    else {
+      set->elts[i + j + 1] = batch[j];
+      set->prefixes[i + j + 1] = prefixOf (batch[j]);
+      j--;
+    }
+  }
+
+  set->count += k;
+
+  free (batch);
+
+  return k;
+}
+
+/*
+ * Function:    deleteElements
+ *
+ * Description: Deletes the `n` strings in `elts` from `set`, and returns how many were
+ *		deleted. The batch is sorted, then the array is compacted in one pass that
+ *		walks it alongside the batch and keeps the elements not in it.
+ *
+ * Complexity:  O(n + mlogm), where n is the number of elements and m the batch size
+ */
+int deleteElements (SET *set, char **elts, int n)
+{
+  char **batch;
+
+  int i, j, k, m, diff, found;
+
+  if ((batch = sortBatch (elts, n, &m)) == NULL)
+    return 0;
+
+  /* Nothing before the first string of the batch is deleted. */
+
+  k = m > 0 ? locateElement (set, batch[0], &found) : set->count;
+
+  for (i = k, j = 0; i < set->count; i++) {
+
+    diff = 1;
+
+    while (j < m && (diff = strcmp (batch[j], set->elts[i])) < 0)
+      j++;
+
+    if (diff != 0) {
+      set->elts[k] = set->elts[i];
+      set->prefixes[k++] = set->prefixes[i];
+    }
+  }
+
+  free (batch);
+
+  if (k < set->count)
+    thawSet (set);
+
+  n = set->count - k;
+
+  set->count = k;
+
+  return n;
+}
+
+/*
+ * Function:	gallop
+ *
+ * Description: Returns the index of the first string in `elts` from `lo` up to `hi` that
+ *		is not less than `key`, or `hi` if there is none. The search probes
+ *		`lo`, `lo` + 1, `lo` + 3, `lo` + 7 and so on until it passes `key`, then
+ *		binary searches the last step, so its cost depends on how far the
+ *		answer is from `lo` rather than on the length of the array.
+ *
+ * Complexity:  O(logd), where d is the distance from `lo` to the result
+ */
+static int gallop (char **elts, int lo, int hi, char *key)
+{
+  int low, mid, high, bound;
+
+  if (lo >= hi || strcmp (elts[lo], key) >= 0)
+    return lo;
+
+  for (bound = 1; lo + bound < hi && strcmp (elts[lo + bound], key) < 0; bound *= 2)
+    ;
+
+  /* The string at lo + bound / 2 is less than the key, and the one at lo + bound, if any, is not. */
+
+  low = lo + bound / 2 + 1;
+
+  high = (lo + bound < hi ? lo + bound : hi) - 1;
+
+  while (low <= high) {
+
+    mid = (low + high) / 2;
+
+    if (strcmp (elts[mid], key) < 0)
+      low = mid + 1;
+    else
+      high = mid - 1;
+  }
+
+  return low;
+}
+
+/*
+ * Function:	combineSlice
+ *
+ * Description: Merges the two sorted ranges of a slice into its destination, keeping the
+ *		strings its operation selects. Whenever one range is behind the other,
+ *		the run of strings that it can skip or copy is found by galloping rather
+ *		than stepping one string at a time.
+ *
+ * Complexity:  O(mlog(n/m)), where m and n are the lengths of the shorter and longer range
+ */
+static void *combineSlice (void *arg)
+{
+  SLICE *slice = arg;
+
+  char **a = slice->a, **b = slice->b, **dst = slice->dst;
+
+  int i, j, k, diff;
+
+  i = j = 0;
+
+  while (i < slice->na && j < slice->nb) {
+
+    diff = strcmp (a[i], b[j]);
+
+    if (diff < 0) {
+
+      k = gallop (a, i + 1, slice->na, b[j]);
+
+      if (slice->op != INTERSECTION) {
+	memcpy (dst, a + i, (k - i) * sizeof(char *));
+	dst += k - i;
+      }
+
+      i = k;
+    }
+
+    else if (diff > 0) {
+
+      k = gallop (b, j + 1, slice->nb, a[i]);
+
+      if (slice->op == UNION) {
+	memcpy (dst, b + j, (k - j) * sizeof(char *));
+	dst += k - j;
+      }
+
+      j = k;
+    }
+
+    else {
+
+      if (slice->op != DIFFERENCE)
+	*dst++ = a[i];
+
+      i++;
+
+      j++;
+    }
+  }
+
+  if (slice->op != INTERSECTION) {
+    memcpy (dst, a + i, (slice->na - i) * sizeof(char *));
+    dst += slice->na - i;
+  }
+
+  if (slice->op == UNION) {
+    memcpy (dst, b + j, (slice->nb - j) * sizeof(char *));
+    dst += slice->nb - j;
+  }
+
+  slice->count = dst - slice->dst;
+
+  return NULL;
+}
+
+/*
+ * Function:	combineSets
+ *
+ * Description: Creates and returns the set holding the result of the operation `op` on `a`
+ *		and `b`, or NULL if out of memory. The larger set is cut into `threads`
+ *		slices of equal length, the smaller one is cut at the first string of
+ *		each of those, and the slices are merged by separate threads. Each
+ *		slice writes to its own part of the result, starting at the number of
+ *		strings before it in both sets, and the parts are then moved together.
+ *
+ * Complexity:  O(mlog(n/m)/threads + threads * logm) - plus O(m + n) for a union
+ */
+static SET *combineSets (SET *a, SET *b, int op, int threads)
+{
+  SET *set, *large;
+
+  SLICE *slices;
+
+  int i, cut, lo[2], hi[2];
+
+  if ((set = createSet (a->count + b->count > 0 ? a->count + b->count : 1)) == NULL)
+    return NULL;
+
+  large = a->count >= b->count ? a : b;
+
+  if (threads > large->count)
+    threads = large->count;
+
+  if (threads < 1)
+    threads = 1;
+
+  if ((slices = malloc (threads * sizeof(SLICE))) == NULL) {
+    destroySet (set);
+    return NULL;
+  }
+
+  /* lo and hi hold the bounds of the current slice in a and in b. */
+
+  lo[0] = lo[1] = 0;
+
+  for (i = 0; i < threads; i++) {
+
+    if (i == threads - 1) {
+      hi[0] = a->count;
+      hi[1] = b->count;
+    }
+
+    else if (large == a) {
+      cut = (long long) a->count * (i + 1) / threads;
+      hi[0] = cut;
+      hi[1] = gallop (b->elts, lo[1], b->count, a->elts[cut]);
+    }
+
+    else {
+      cut = (long long) b->count * (i + 1) / threads;
+      hi[1] = cut;
+      hi[0] = gallop (a->elts, lo[0], a->count, b->elts[cut]);
+    }
+
+    slices[i].a = a->elts + lo[0];
+    slices[i].na = hi[0] - lo[0];
+    slices[i].b = b->elts + lo[1];
+    slices[i].nb = hi[1] - lo[1];
+    slices[i].dst = set->elts + lo[0] + lo[1];
+    slices[i].op = op;
+
+    lo[0] = hi[0];
+    lo[1] = hi[1];
+  }
+
+  runParallel (combineSlice, slices, sizeof(SLICE), threads);
+
+  for (i = 0; i < threads; i++) {
+    memmove (set->elts + set->count, slices[i].dst, slices[i].count * sizeof(char *));
+    set->count += slices[i].count;
+  }
+
+  fillPrefixes (set, 0);
+
+  free (slices);
+
+  return set;
+}
+
+/*
+ * Function:	unionSets
+ *
+ * Description: Creates and returns a set of the elements in `a` or `b`, with a maximum
+ *		capacity of their combined sizes, using `threads` threads. Returns NULL if
+ *		out of memory. The strings are shared with `a` and `b`, not copied.
+ *
+ * Complexity:  O(m + n), where m and n are the sizes of the sets
+ */
+SET *unionSets (SET *a, SET *b, int threads)
+{
+  return combineSets (a, b, UNION, threads);
+}
+
+/*
+ * Function:	intersectSets
+ *
+ * Description: Creates and returns a set of the elements in both `a` and `b`, as for
+ *		unionSets. Every element of the smaller set is galloped to in the larger
+ *		one, so the cost is close to that of the smaller set when the sizes are skewed.
+ *
+ * Complexity:  O(mlog(n/m)), where m is the size of the smaller set and n of the larger
+ */
+SET *intersectSets (SET *a, SET *b, int threads)
+{
+  return combineSets (a, b, INTERSECTION, threads);
+}
+
+/*
+ * Function:	differenceSets
+ *
+ * Description: Creates and returns a set of the elements in `a` that are not in `b`, as
+ *		for unionSets. The runs of `a` between elements of `b` are copied whole.
+ *
+ * Complexity:  O(mlog(n/m)) comparisons, where m is the size of the smaller set and n
+ *		of the larger, plus O(size of `a`) to copy the result
+ */
+SET *differenceSets (SET *a, SET *b, int threads)
+{
+  return combineSets (a, b, DIFFERENCE, threads);
+}
+
+/*
+ * Function:    destroySet
+ *
+ * Description: Deallocates memory associated with `set`.
+ *
+ * Complexity: O(1)
+ */
+void destroySet (SET *set)
+{
+  free (set->eytz);
+
+  free (set->ranks);
+
+  free (set->model);
+
+  free (set->elts);
+
+  free (set->prefixes);
 
   free (set);
 
@@ -24,3 +24,27 @@ int hasElement (SET *set, char *elt);
 int insertElement (SET *set, char *elt);
 
 int deleteElement (SET *set, char *elt);
+
+char **sortElements (SET *set);
+
+int rangeScan (SET *set, char *lo, char *hi, int (*visit) (char *elt, void *arg), void *arg);
+
+int prefixScan (SET *set, char *prefix, int (*visit) (char *elt, void *arg), void *arg);
+
+SET *createSetFromArray (char **keys, int n, int threads);
+
+int freezeSet (SET *set);
+
+void thawSet (SET *set);
+
+int learnSet (SET *set, int error);
+
+int insertElements (SET *set, char **elts, int n);
+
+int deleteElements (SET *set, char **elts, int n);
+
+SET *unionSets (SET *a, SET *b, int threads);
+
+SET *intersectSets (SET *a, SET *b, int threads);
+
+SET *differenceSets (SET *a, SET *b, int threads);
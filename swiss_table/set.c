@@ -0,0 +1,433 @@
+/*
+ * File:	set.c
+ *
+ * Description:	This file contains the implementation for a set abstract data type.
+ *              The algorithm used to implement the set is an open addressing hash table
+ *              whose slots are split into groups of sixteen. Next to the array of
+ *              element strings, a control byte per slot records whether it is empty,
+ *              deleted, or filled, and for a filled slot also holds 7 bits of the
+ *              element's hash. A probe loads the control bytes of a whole group and
+ *              compares all sixteen against the hash bits at once (using SSE2 where
+ *              available), so strings are only compared on a matching slot and most
+ *              unsuccessful lookups touch a single group of control bytes.
+ *
+ *              Groups are probed in triangular order, so every group is eventually
+ *              visited. Determining membership, insertion and deletion have constant
+ *              time for the average case.
+ *
+ *              A set is an unordered collection of unique elements. Each element is a string.
+ *
+ */
+
+# include <stdio.h>
+# include <stdlib.h>
+# include <string.h>
+# include "set.h"
+# include "../common/hash.h"
+
+# ifdef __SSE2__
+# include <emmintrin.h>
+# endif
+
+# define EMPTY ((signed char) 0x80) /* Control byte of an empty slot */
+# define DEL ((signed char) 0xFE) /* Control byte of a deleted slot */
+
+# define GROUP 16 /* Number of slots whose control bytes are matched at once */
+# define MIN_SIZE GROUP /* The smallest array ever allocated */
+
+/* Definition of the `set` data type */
+struct set
+{
+  int count; /* The number of elements currently in `elts` */
+
+  int size; /* The size of `elts`, a power of two and a multiple of GROUP */
+
+  int used; /* The number of filled or deleted slots */
+
+  char **elts; /* The array of element strings */
+
+  signed char *ctrl; /* The control byte of each slot: EMPTY, DEL, or 7 bits of the hash */
+};
+
+/* Private function prototypes */
+static unsigned matchByte (signed char *ctrl, signed char c);
+static unsigned matchFree (signed char *ctrl);
+static int nextBit (unsigned *mask);
+static int locateElement (SET *set, char *elt, unsigned long long hash, int *found);
+static int freeSlot (SET *set, unsigned long long hash);
+static int resizeSet (SET *set, int size);
+
+/*
+ * Function:	matchByte
+ *
+ * Description: Returns a bit mask with bit i set if control byte i of the group
+ *		starting at `ctrl` equals `c`.
+ *
+ * Complexity:  O(1)
+ */
+static unsigned matchByte (signed char *ctrl, signed char c)
+{
+# ifdef __SSE2__
+  __m128i group = _mm_loadu_si128 ((const __m128i *) ctrl);
+
+  return _mm_movemask_epi8 (_mm_cmpeq_epi8 (group, _mm_set1_epi8 (c)));
+# else
+  int i;
+
+  unsigned mask = 0;
+
+  for (i = 0; i < GROUP; i++)
+    if (ctrl[i] == c)
+      mask |= 1u << i;
+
+  return mask;
+# endif
+}
+
+/*
+ * Function:	matchFree
+ *
+ * Description: Returns a bit mask with bit i set if slot i of the group starting at
+ *		`ctrl` is empty or deleted. Both have the sign bit of their control
+ *		byte set, while a filled slot never does.
+ *
+ * Complexity:  O(1)
+ */
+static unsigned matchFree (signed char *ctrl)
+{
+# ifdef __SSE2__
+  return _mm_movemask_epi8 (_mm_loadu_si128 ((const __m128i *) ctrl));
+# else
+  int i;
+
+  unsigned mask = 0;
+
+  for (i = 0; i < GROUP; i++)
+    if (ctrl[i] < 0)
+      mask |= 1u << i;
+
+  return mask;
+# endif
+}
+
+/*
+ * Function:	nextBit
+ *
+ * Description: Clears the lowest set bit of the non-zero `mask` and returns its index.
+ *
+ * Complexity:  O(1)
+ */
+static int nextBit (unsigned *mask)
+{
+  int i;
+
+# ifdef __GNUC__
+  i = __builtin_ctz (*mask);
+# else
+  for (i = 0; !(*mask & (1u << i)); i++)
+    ;
+# endif
+
+  *mask &= *mask - 1;
+
+  return i;
+}
+
+/*
+ * Function:	locateElement
+ *
+ * Description: Returns the location of an element in the `set`, given its `hash`.
+ *              If element present: return its index, and set `found` pointer to 1.
+ *		Otherwise return -1, and set found pointer to 0. The search ends at the
+ *		first group that contains an empty slot.
+ *
+ * Complexity:  O(1) - average case
+ *		O(n) - worst case
+ */
+static int locateElement (SET *set, char *elt, unsigned long long hash, int *found)
+{
+  int group, groups, i, locn;
+
+  unsigned mask;
+
+  groups = set->size / GROUP;
+
+  group = (hash >> 7) & (groups - 1);
+
+  for (i = 0; i < groups; i++) {
+
+    mask = matchByte (set->ctrl + group * GROUP, hash & 0x7f);
+
+    while (mask != 0) {
+
+      locn = group * GROUP + nextBit (&mask);
+
+      if (strcmp (set->elts[locn], elt) == 0) {
+        *found = 1;
+        return locn;
+      }
+    }
+
+    if (matchByte (set->ctrl + group * GROUP, EMPTY) != 0)
+      break;
+
+    group = (group + i + 1) & (groups - 1);
+  }
+
+  *found = 0;
+  return -1;
+}
+
+/*
+ * Function:	freeSlot
+ *
+ * Description: Returns the first empty or deleted slot on the probe sequence of `hash`.
+ *		The array always has one, since it is never allowed to fill completely.
+ *
+ * Complexity:  O(1) - average case
+ *		O(n) - worst case
+ */
+static int freeSlot (SET *set, unsigned long long hash)
+{
+  int group, groups, i;
+
+  unsigned mask;
+
+  groups = set->size / GROUP;
+
+  group = (hash >> 7) & (groups - 1);
+
+  for (i = 0; (mask = matchFree (set->ctrl + group * GROUP)) == 0; i++)
+    group = (group + i + 1) & (groups - 1);
+
+  return group * GROUP + nextBit (&mask);
+}
+
+/*
+ * Function:	resizeSet
+ *
+ * Description: Replaces the array of `set` with one of `size` slots and stores every
+ *		element again, which also drops all deleted slots. Returns 0 if the array
+ *		could not be allocated, leaving `set` unchanged.
+ *
+ * Complexity:  O(n)
+ */
+static int resizeSet (SET *set, int size)
+{
+  int i, locn, oldSize;
+
+  unsigned long long hash;
+
+  char **oldElts;
+
+  signed char *oldCtrl;
+
+  oldSize = set->size;
+
+  oldElts = set->elts;
+
+  oldCtrl = set->ctrl;
+
+  if ((set->elts = malloc (size * sizeof(char *))) == NULL) {
+    set->elts = oldElts;
+    return 0;
+  }
+
+  if ((set->ctrl = malloc (size * sizeof(signed char))) == NULL) {
+    free (set->elts);
+    set->elts = oldElts;
+    set->ctrl = oldCtrl;
+    return 0;
+  }
+
+  set->size = size;
+
+  set->used = set->count;
+
+  memset (set->ctrl, EMPTY, size);
+
+  for (i = 0; i < oldSize; i++)
+    if (oldCtrl[i] >= 0) {
+
+      hash = hashString (oldElts[i]);
+
+      locn = freeSlot (set, hash);
+
+      set->elts[locn] = oldElts[i];
+
+      set->ctrl[locn] = hash & 0x7f;
+    }
+
+  free (oldElts);
+
+  free (oldCtrl);
+
+  return 1;
+}
+
+/*
+ * Function:	createSet
+ *
+ * Description: Initializes and returns a set with an initial capacity of `size`.
+ *		The set grows as elements are inserted.
+ *
+ * Complexity:  O(n)
+ */
+SET *createSet (int size)
+{
+  SET *s;
+
+  int slots = MIN_SIZE;
+
+  while (slots / 8 * 7 < size)
+    slots *= 2;
+
+  s = malloc (sizeof(SET));
+
+  if (s == NULL)
+    return NULL;
+
+  s->elts = malloc (slots * sizeof(char *));
+
+  if (s->elts == NULL)
+    return NULL;
+
+  s->ctrl = malloc (slots * sizeof(signed char));
+
+  if (s->ctrl == NULL)
+    return NULL;
+
+  s->count = 0;
+
+  s->size = slots;
+
+  s->used = 0;
+
+  memset (s->ctrl, EMPTY, slots);
+
+  return s;
+}
+
+/*
+ * Function:	insertElement
+ *
+ * Description: Inserts `elt` into `set`, and returns whether the set changed. Once
+ *		7/8 of the slots are filled or deleted the array is rebuilt, twice as
+ *		large unless most of those slots are deleted ones.
+ *
+ * Complexity:  O(1) - average case
+ *		O(n) - worst case, or when the array has to be rebuilt
+ */
+int insertElement (SET *set, char *elt)
+{
+  int locn, found;
+
+  unsigned long long hash;
+
+  hash = hashString (elt);
+
+  locateElement (set, elt, hash, &found);
+
+  if (found)
+    return 0;
+
+  locn = freeSlot (set, hash);
+
+  if (set->ctrl[locn] == EMPTY && set->used + 1 > set->size / 8 * 7) {
+
+    if (!resizeSet (set, set->count * 2 >= set->size ? set->size * 2 : set->size))
+      return 0;
+
+    locn = freeSlot (set, hash);
+  }
+
+  if (set->ctrl[locn] == EMPTY)
+    set->used++;
+
+  set->elts[locn] = elt;
+
+  set->ctrl[locn] = hash & 0x7f;
+
+  set->count++;
+
+  return 1;
+}
+
+/*
+ * Function:	numElements
+ *
+ * Description:	Returns the number of elements in `set`
+ *
+ * Complexity:  O(1)
+ */
+int numElements (SET *set)
+{
+  return set->count;
+}
+
+/*
+ * Function:    hasElement
+ *
+ * Description: Returns if `elt` is a member of `set`.
+ *
+ * Complexity:  O(1) - average case
+ *		O(n) - worst case
+ */
+int hasElement (SET *set, char *elt)
+{
+  int found;
+
+  locateElement (set, elt, hashString (elt), &found);
+
+  return found;
+}
+
+/*
+ * Function:    deleteElement
+ *
+ * Description: Deletes `elt` from `set`, and returns whether the set changed. If the
+ *		slot's group still has an empty slot then no search can have probed past
+ *		it, so the slot is marked empty rather than deleted.
+ *
+ * Complexity:  O(1) - average case
+ *		O(n) - worst case
+ */
+int deleteElement (SET *set, char *elt)
+{
+  int locn, found;
+
+  locn = locateElement (set, elt, hashString (elt), &found);
+
+  if (!found)
+    return 0;
+
+  if (matchByte (set->ctrl + locn / GROUP * GROUP, EMPTY) != 0) {
+    set->ctrl[locn] = EMPTY;
+    set->used--;
+  }
+
+  else
+    set->ctrl[locn] = DEL;
+
+  set->count--;
+
+  return 1;
+}
+
+/*
+ * Function:    destroySet
+ *
+ * Description: Deallocates memory associated with `set`.
+ *
+ * Complexity:  O(1)
+ */
+void destroySet (SET *set)
+{
+  free (set->ctrl);
+
+  free (set->elts);
+
+  free (set);
+
+  return;
+}